@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// STL ALLOCATOR THAT HANDS OUT MEMORY ALIGNED TO A CACHE LINE (OR MORE)
+template<typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+	typedef T value_type;
+
+	template<typename U>
+	struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+	AlignedAllocator() {}
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+	T* allocate(std::size_t n)
+	{
+		void* p = NULL;
+#ifdef _WIN32
+		p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+		if(posix_memalign(&p, Alignment, n * sizeof(T)) != 0) p = NULL;
+#endif
+		if(p == NULL) throw std::bad_alloc();
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, std::size_t)
+	{
+#ifdef _WIN32
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+};
+
+template<typename T, typename U, std::size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return true; }
+template<typename T, typename U, std::size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return false; }
+
+// CONTIGUOUS, CACHE LINE ALIGNED ARRAY
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T> >;
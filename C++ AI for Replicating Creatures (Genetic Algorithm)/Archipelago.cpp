@@ -0,0 +1,177 @@
+#include "Archipelago.h"
+#include "Profiler.h"
+
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+Archipelago::Archipelago(sf::Vector2u& windowSize, unsigned int islands, unsigned int capacity, unsigned long long seed)
+	: windowSize(&windowSize), interval(100), rate(.01f), pinned(true)
+{
+	if(islands == 0)
+		islands = 1;
+	for(unsigned int i = 0; i < islands; ++i)
+		this->islands.push_back(std::unique_ptr<CreaturePool>(new CreaturePool(windowSize, capacity, seed)));
+	nextIds.resize(islands, 0);
+	emigrants.resize(islands, 0);
+	lost.resize(islands, 0);
+	births.resize(islands, 0);
+}
+
+// EVERY interval TICKS, rate OF EVERY ISLAND'S POPULATION MOVES ON TO THE NEXT ISLAND
+void Archipelago::setMigration(unsigned int interval, float rate)
+{
+	this->interval = interval;
+	this->rate = (rate < 0.f) ? 0.f : (rate > 1.f) ? 1.f : rate;
+	queues.clear();
+}
+
+void Archipelago::setPinned(bool pinned)
+{
+	this->pinned = pinned;
+}
+
+// count RANDOM CREATURES ON EVERY ISLAND
+// island i hands out the ids i, i + islands, i + 2 islands... so ids stay unique in the whole archipelago
+void Archipelago::populate(unsigned int count)
+{
+	int id = Creature::ID, step = Creature::ID_STEP;
+	Creature::ID_STEP = islands.size();
+	for(unsigned int i = 0; i < islands.size(); ++i)
+	{
+		Creature::ID = (nextIds[i] == 0) ? (int)i : nextIds[i];
+		for(unsigned int c = 0; c < count; ++c)
+			islands[i]->spawn();
+		nextIds[i] = Creature::ID;
+	}
+	Creature::ID = id;
+	Creature::ID_STEP = step;
+}
+
+// ticks SIMULATION STEPS ON EVERY ISLAND, ONE THREAD PER ISLAND
+void Archipelago::run(unsigned int ticks)
+{
+  // A QUEUE HOLDS AT MOST TWO EPOCHS: AN ISLAND CAN'T GET MORE THAN ONE AHEAD OF THE NEXT ONE
+	if(queues.empty() && islands.size() > 1)
+	{
+		unsigned int batch = (unsigned int)(islands[0]->getCapacity() * rate) + 1;
+		for(unsigned int i = 0; i < islands.size(); ++i)
+			queues.push_back(std::unique_ptr<SpscRing<CreatureRecord> >(new SpscRing<CreatureRecord>(2 * batch)));
+	}
+
+	std::vector<std::thread> threads;
+	for(unsigned int i = 0; i < islands.size(); ++i)
+		threads.push_back(std::thread(&Archipelago::runIsland, this, i, ticks));
+	for(unsigned int i = 0; i < threads.size(); ++i)
+		threads[i].join();
+}
+
+void Archipelago::runIsland(unsigned int island, unsigned int ticks)
+{
+#ifdef __linux__
+	if(pinned)
+	{
+		unsigned int cores = std::thread::hardware_concurrency();
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(island % ((cores == 0) ? 1 : cores), &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	}
+#endif
+
+	Creature::ID = nextIds[island];
+	Creature::ID_STEP = islands.size();
+	int first = Creature::ID;
+
+	CreaturePool& pool = *islands[island];
+	for(unsigned int t = 0; t < ticks; ++t)
+	{
+		pool.tick(1);
+		if(!queues.empty() && interval > 0 && pool.getTickCount() % interval == 0)
+			migrate(island);
+	}
+
+  // EVERY BIRTH MOVED THE ID COUNTER ON BY THE NUMBER OF ISLANDS
+	births[island] += (Creature::ID - first) / (int)islands.size();
+	nextIds[island] = Creature::ID;
+}
+
+// SEND EMIGRANTS TO THE NEXT ISLAND, THEN TAKE IN EVERYONE FROM THE ONE BEFORE
+// every island is at the same tick here, so births (ticks of the lifecycle clock) stay valid
+void Archipelago::migrate(unsigned int island)
+{
+	PROFILE_SCOPE("migrate");
+	CreaturePool& pool = *islands[island];
+	CreatureData& data = pool.data;
+	const std::vector<Creature*>& creatures = pool.creatures;
+	SpscRing<CreatureRecord>& out = *queues[island];
+	SpscRing<CreatureRecord>& in = *queues[(island + islands.size() - 1) % islands.size()];
+
+  // EVENLY SPREAD OVER THE POPULATION, CREATURES WITH A PARTNER STAY
+	unsigned int n = creatures.size();
+	unsigned int count = (unsigned int)(n * rate);
+	std::vector<Creature*> leaving;
+	leaving.reserve(count);
+	for(unsigned int k = 0; k < count; ++k)
+	{
+		Creature* c = creatures[(unsigned int)((unsigned long long)k * n / count)];
+		if(c->getPartner() == NULL)
+			leaving.push_back(c);
+	}
+
+  // GONE: ITS LIFECYCLE EVENTS AND HANDLES GO STALE
+	for(unsigned int i = 0; i < leaving.size(); ++i)
+	{
+		while(!out.push(CreatureRecord::capture(data, leaving[i], -1)))
+			std::this_thread::yield();
+		pool.release(leaving[i]);
+	}
+	emigrants[island] += leaving.size();
+
+  // END OF THIS EPOCH'S BATCH
+	CreatureRecord end = CreatureRecord();
+	end.id = -1;
+	while(!out.push(end))
+		std::this_thread::yield();
+
+	CreatureRecord r;
+	for(;;)
+	{
+		if(!in.pop(r))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		if(r.id < 0)
+			break;
+
+		Creature* c = pool.allocate();
+		if(c == NULL)
+		{
+			++lost[island];
+			continue;
+		}
+		r.restore(data, c);
+		pool.settle(c);
+		if(pool.useNeighbourLists) pool.neighbours.addNewborn(c);
+	}
+}
+
+unsigned int Archipelago::getCount() const
+{
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < islands.size(); ++i)
+		count += islands[i]->getCount();
+	return count;
+}
+
+unsigned long long Archipelago::getBirths() const
+{
+	unsigned long long count = 0;
+	for(unsigned int i = 0; i < islands.size(); ++i)
+		count += births[i];
+	return count;
+}
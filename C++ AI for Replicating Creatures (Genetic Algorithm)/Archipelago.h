@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <memory>
+#include <vector>
+
+#include "CreaturePool.h"
+#include "CreatureRecord.h"
+#include "SpscRing.h"
+
+// ISLAND MODEL: SEVERAL INDEPENDENT WORLDS, EACH ON ITS OWN THREAD (PINNED TO ITS OWN CORE ON LINUX)
+// the islands share nothing while they tick. every interval ticks each island sends a
+// fraction of its creatures (spread evenly over its population, never one with a partner)
+// to the next island of the ring and takes in the ones of the island before it. that's
+// the only point where an island can wait for another one, so the result doesn't depend on
+// timing: islands hand out interleaved ids, migrants keep their genes, age and dice.
+// all islands have the same size and seed
+class Archipelago
+{
+private:
+	sf::Vector2u* windowSize;
+	std::vector<std::unique_ptr<CreaturePool> > islands;
+  // migrants from island i to the next one
+	std::vector<std::unique_ptr<SpscRing<CreatureRecord> > > queues;
+
+  // every island's id counter between two runs (ids are handed out per thread)
+	std::vector<int> nextIds;
+
+	unsigned int interval;
+	float rate;
+	bool pinned;
+
+	std::vector<unsigned long long> emigrants;
+	std::vector<unsigned long long> lost;
+	std::vector<unsigned long long> births;
+
+	void runIsland(unsigned int island, unsigned int ticks);
+	void migrate(unsigned int island);
+
+public:
+  // constructor
+	Archipelago(sf::Vector2u&, unsigned int islands, unsigned int capacity, unsigned long long seed = 0);
+
+  // Methods
+	void setMigration(unsigned int interval, float rate);
+	void setPinned(bool);
+	void populate(unsigned int count);
+	void run(unsigned int ticks);
+
+  // GETTERS
+	unsigned int getIslandCount() const { return islands.size(); }
+	CreaturePool& getIsland(unsigned int i) { return *islands[i]; }
+	unsigned long long getEmigrants(unsigned int i) const { return emigrants[i]; }
+	unsigned long long getLost(unsigned int i) const { return lost[i]; }
+	unsigned int getCount() const;
+	unsigned long long getBirths() const;
+
+private:
+	Archipelago(const Archipelago&);
+	Archipelago& operator=(const Archipelago&);
+};
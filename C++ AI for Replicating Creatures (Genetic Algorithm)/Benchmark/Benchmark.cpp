@@ -0,0 +1,278 @@
+// HEADLESS BENCHMARK OF THE SIMULATION
+// runs every scenario at every population size and prints one line per run:
+//   ticks per second, nanoseconds per creature for every phase of a tick, births and deaths per second
+//   and the state hash of the whole run (StateHash, every tick; same hash = same simulation)
+//
+//   benchmark [--seed=N] [--ticks=N] [--min=N] [--max=N] [--threads=N] [--scenario=NAME] [--skin=N | --skin=off]
+//
+// the same seed gives the same simulation on every build, so numbers can be compared across commits
+
+#include "../CreaturePool.h"
+#include "../BirthKernel.h"
+#include "../CollisionKernel.h"
+#include "../StateHash.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace
+{
+	enum Scenario
+	{
+		UNIFORM,
+		CLUSTERS,
+		ALL_READY,
+		DIE_OFF,
+		MUTATED,
+		SCENARIO_COUNT
+	};
+
+	const char* SCENARIO_NAMES[SCENARIO_COUNT] = { "uniform", "clusters", "all-ready", "die-off", "mutated" };
+
+  // same density as 1000 creatures on a 1280x720 window
+	const float AREA_PER_CREATURE = 1280.f * 720.f / 1000.f;
+	const unsigned int CLUSTER_COUNT = 16;
+
+	enum Phase
+	{
+		UPDATE,
+		REMOVE_DEAD,
+		SEARCH_PARTNERS,
+		REPLICATE,
+		HASH,
+		PHASE_COUNT
+	};
+
+	struct Settings
+	{
+		unsigned long long seed;
+		unsigned int ticks;
+		unsigned int minPopulation;
+		unsigned int maxPopulation;
+		unsigned int threads;
+		int scenario;
+		float skin;
+	};
+
+	struct Result
+	{
+		double seconds;
+		double phaseSeconds[PHASE_COUNT];
+		unsigned long long creatureTicks;
+		unsigned int births;
+		unsigned int deaths;
+		unsigned int finalCount;
+		unsigned long long hash;
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	double since(Clock::time_point start)
+	{
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+  // SHAPE THE STARTING POPULATION
+	void setup(CreaturePool& pool, Scenario scenario, const Settings& settings, unsigned int ticks)
+	{
+		CreatureData& data = pool.getData();
+		std::vector<Creature*>& creatures = pool.getCreatures();
+		std::mt19937 random((unsigned int)settings.seed);
+
+		switch(scenario)
+		{
+		case CLUSTERS:
+		{
+      // EVERYONE PACKED AROUND A FEW SPOTS
+			sf::Vector2f centres[CLUSTER_COUNT];
+			for(unsigned int c = 0; c < CLUSTER_COUNT; ++c)
+				centres[c] = sf::Vector2f(random() % data.windowSize->x, random() % data.windowSize->y);
+
+			std::normal_distribution<float> spread(0.f, 40.f);
+			for(unsigned int i = 0; i < creatures.size(); ++i)
+			{
+				unsigned int slot = creatures[i]->getSlot();
+				sf::Vector2f p = centres[i % CLUSTER_COUNT];
+				data.position[slot] = sf::Vector2f(p.x + spread(random), p.y + spread(random));
+				creatures[i]->setTargetPosition(data.position[slot]);
+			}
+			break;
+		}
+		case ALL_READY:
+      // EVERYONE WANTS A PARTNER FROM THE FIRST TICK ON, AND IS DONE WITH IT QUICKLY
+      // (replications take 200+ ticks otherwise, a short run would never see a birth)
+			for(unsigned int i = 0; i < creatures.size(); ++i)
+			{
+				unsigned int slot = creatures[i]->getSlot();
+				data.genes.get<Genome::TimeToReplicate>()[slot] = 0;
+				data.genes.get<Genome::ReplicationDuration>()[slot] = 1 + random() % std::max(ticks / 8, 1u);
+			}
+			break;
+		case DIE_OFF:
+      // EVERYONE DIES WITHIN THE FIRST HALF OF THE RUN
+			for(unsigned int i = 0; i < creatures.size(); ++i)
+				data.genes.get<Genome::TimeToLive>()[creatures[i]->getSlot()] = 1 + random() % std::max(ticks / 2, 1u);
+			break;
+		case MUTATED:
+      // GENERATIONS OF SIGHT MUTATIONS: MOSTLY SHORT-SIGHTED, A FEW SEE VERY FAR
+			for(unsigned int i = 0; i < creatures.size(); ++i)
+			{
+				unsigned int slot = creatures[i]->getSlot();
+				data.genes.get<Genome::SightRadius>()[slot] = creatures[i]->getSize() + ((random() % 10 == 0) ? random() % 400 : random() % 20);
+			}
+			break;
+		default:
+			break;
+		}
+
+  // THE TIMERS CHANGED, THE LIFECYCLE HAS TO KNOW
+		for(unsigned int i = 0; i < creatures.size(); ++i)
+			creatures[i]->scheduleLifecycle();
+	}
+
+	Result run(Scenario scenario, unsigned int population, const Settings& settings, ThreadPool* threads)
+	{
+		float side = sqrtf(population * AREA_PER_CREATURE / (1280.f * 720.f));
+		sf::Vector2u windowSize((unsigned int)(1280 * side), (unsigned int)(720 * side));
+
+  // IDS FEED THE RANDOM NUMBERS, EVERY RUN STARTS FROM 0
+		Creature::ID = 0;
+		std::unique_ptr<CreaturePool> pool(new CreaturePool(windowSize, population * 2, settings.seed));
+		pool->setThreadPool(threads);
+		pool->setNeighbourLists(settings.skin >= 0.f, settings.skin);
+		for(unsigned int i = 0; i < population; ++i)
+			pool->spawn();
+		setup(*pool, scenario, settings, settings.ticks);
+
+		Result result;
+		memset(&result, 0, sizeof(result));
+
+		StateHash hashes;
+		int firstId = Creature::ID;
+		Clock::time_point start = Clock::now();
+		for(unsigned int t = 0; t < settings.ticks; ++t)
+		{
+			result.creatureTicks += pool->getCount();
+
+    // SAME PHASES AS CreaturePool::tick, TIMED ONE BY ONE
+			Clock::time_point phase = Clock::now();
+			pool->update(1);
+			result.phaseSeconds[UPDATE] += since(phase);
+
+			phase = Clock::now();
+			pool->removeDead();
+			result.phaseSeconds[REMOVE_DEAD] += since(phase);
+
+			phase = Clock::now();
+			pool->searchPartners();
+			result.phaseSeconds[SEARCH_PARTNERS] += since(phase);
+
+			phase = Clock::now();
+			pool->replicate();
+			result.phaseSeconds[REPLICATE] += since(phase);
+
+			phase = Clock::now();
+			hashes.record(*pool, t);
+			result.phaseSeconds[HASH] += since(phase);
+		}
+      // THE HASH IS A CHECK ON TOP OF THE SIMULATION, IT HAS ITS OWN COLUMN BUT ISN'T PART OF ticks/s
+		result.seconds = since(start) - result.phaseSeconds[HASH];
+
+		result.births = Creature::ID - firstId;
+		result.finalCount = pool->getCount();
+		result.deaths = population + result.births - result.finalCount;
+		result.hash = hashes.getChain();
+		return result;
+	}
+
+	bool readOption(const char* arg, const char* name, std::string& value)
+	{
+		size_t length = strlen(name);
+		if(strncmp(arg, name, length) != 0 || arg[length] != '=')
+			return false;
+		value = arg + length + 1;
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Settings settings;
+	settings.seed = 1;
+	settings.ticks = 200;
+	settings.minPopulation = 1000;
+	settings.maxPopulation = 1000000;
+	settings.threads = 1;
+	settings.scenario = -1;
+	settings.skin = 20.f;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string value;
+		if(readOption(argv[i], "--seed", value)) settings.seed = strtoull(value.c_str(), NULL, 10);
+		else if(readOption(argv[i], "--ticks", value)) settings.ticks = atoi(value.c_str());
+		else if(readOption(argv[i], "--min", value)) settings.minPopulation = atoi(value.c_str());
+		else if(readOption(argv[i], "--max", value)) settings.maxPopulation = atoi(value.c_str());
+		else if(readOption(argv[i], "--threads", value)) settings.threads = atoi(value.c_str());
+		else if(readOption(argv[i], "--skin", value)) settings.skin = (value == "off") ? -1.f : (float)atof(value.c_str());
+		else if(readOption(argv[i], "--scenario", value))
+		{
+			for(int s = 0; s < SCENARIO_COUNT; ++s)
+				if(value == SCENARIO_NAMES[s]) settings.scenario = s;
+			if(settings.scenario < 0)
+			{
+				fprintf(stderr, "unknown scenario %s\n", value.c_str());
+				return 1;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--seed=N] [--ticks=N] [--min=N] [--max=N] [--threads=N] [--scenario=uniform|clusters|all-ready|die-off|mutated] [--skin=N|off]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	ThreadPool threads(settings.threads);
+
+	printf("seed %llu, %u ticks, %u threads, collision kernel %s, birth kernel %s, %u bytes hot state per creature, ",
+		settings.seed, settings.ticks, threads.getThreadCount(), CollisionKernel::getImplementationName(), BirthKernel::getImplementationName(),
+		CreatureData::HOT_BYTES);
+	if(settings.skin >= 0.f)
+		printf("neighbour lists (skin %.1f)\n", settings.skin);
+	else
+		printf("grid search\n");
+	printf("%-10s %9s %10s %9s %9s %9s %9s %9s %11s %11s %9s %17s\n",
+		"scenario", "creatures", "ticks/s", "update", "remove", "search", "replicate", "hash", "births/s", "deaths/s", "final", "state hash");
+	printf("%-10s %9s %10s %9s %9s %9s %9s %9s %11s %11s %9s %17s\n",
+		"", "", "", "ns/c", "ns/c", "ns/c", "ns/c", "ns/c", "", "", "", "");
+
+	for(int s = 0; s < SCENARIO_COUNT; ++s)
+	{
+		if(settings.scenario >= 0 && s != settings.scenario)
+			continue;
+
+		for(unsigned int population = settings.minPopulation; population <= settings.maxPopulation; population *= 10)
+		{
+			Result r = run((Scenario)s, population, settings, &threads);
+
+			double perCreature = r.creatureTicks > 0 ? 1e9 / r.creatureTicks : 0.;
+			printf("%-10s %9u %10.1f %9.1f %9.1f %9.1f %9.1f %9.1f %11.0f %11.0f %9u  %016llx\n",
+				SCENARIO_NAMES[s], population, settings.ticks / r.seconds,
+				r.phaseSeconds[UPDATE] * perCreature, r.phaseSeconds[REMOVE_DEAD] * perCreature,
+				r.phaseSeconds[SEARCH_PARTNERS] * perCreature, r.phaseSeconds[REPLICATE] * perCreature,
+				r.phaseSeconds[HASH] * perCreature, r.births / r.seconds, r.deaths / r.seconds, r.finalCount, r.hash);
+			fflush(stdout);
+
+      // THE BIRTH SCENARIO DIDN'T MEASURE BIRTHS: ITS replicate COLUMN MEANS NOTHING
+			if(s == ALL_READY && r.births == 0)
+				fprintf(stderr, "warning: no births in all-ready at %u creatures, run more --ticks\n", population);
+		}
+	}
+	return 0;
+}
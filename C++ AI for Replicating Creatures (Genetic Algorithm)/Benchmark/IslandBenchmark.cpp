@@ -0,0 +1,93 @@
+// HEADLESS BENCHMARK OF THE ISLAND MODEL
+// runs the same number of creatures per island for 1, 2, 4... islands (up to --islands)
+// and prints how fast evolution goes: births per second of the whole archipelago
+//
+//   islandbenchmark [--seed=N] [--ticks=N] [--population=N] [--islands=N] [--interval=N] [--rate=F] [--pinning=off]
+
+#include "../Archipelago.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace
+{
+  // same density as 1000 creatures on a 1280x720 window
+	const float AREA_PER_CREATURE = 1280.f * 720.f / 1000.f;
+
+	typedef std::chrono::steady_clock Clock;
+
+	bool readOption(const char* arg, const char* name, std::string& value)
+	{
+		size_t length = strlen(name);
+		if(strncmp(arg, name, length) != 0 || arg[length] != '=')
+			return false;
+		value = arg + length + 1;
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long long seed = 1;
+	unsigned int ticks = 1000;
+	unsigned int population = 10000;
+	unsigned int maxIslands = std::thread::hardware_concurrency();
+	unsigned int interval = 100;
+	float rate = .01f;
+	bool pinned = true;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string value;
+		if(readOption(argv[i], "--seed", value)) seed = strtoull(value.c_str(), NULL, 10);
+		else if(readOption(argv[i], "--ticks", value)) ticks = atoi(value.c_str());
+		else if(readOption(argv[i], "--population", value)) population = atoi(value.c_str());
+		else if(readOption(argv[i], "--islands", value)) maxIslands = atoi(value.c_str());
+		else if(readOption(argv[i], "--interval", value)) interval = atoi(value.c_str());
+		else if(readOption(argv[i], "--rate", value)) rate = (float)atof(value.c_str());
+		else if(readOption(argv[i], "--pinning", value)) pinned = (value != "off");
+		else
+		{
+			fprintf(stderr, "usage: %s [--seed=N] [--ticks=N] [--population=N] [--islands=N] [--interval=N] [--rate=F] [--pinning=off]\n", argv[0]);
+			return 1;
+		}
+	}
+	if(maxIslands == 0)
+		maxIslands = 1;
+
+	float side = sqrtf(population * AREA_PER_CREATURE / (1280.f * 720.f));
+	sf::Vector2u windowSize((unsigned int)(1280 * side), (unsigned int)(720 * side));
+
+	printf("seed %llu, %u ticks, %u creatures per island, migration every %u ticks (%.1f%%)%s\n",
+		seed, ticks, population, interval, rate * 100.f, pinned ? ", pinned" : "");
+	printf("%-8s %10s %12s %12s %11s %6s\n", "islands", "ticks/s", "births/s", "creatures", "migrants", "lost");
+
+	for(unsigned int islands = 1; islands <= maxIslands; islands *= 2)
+	{
+		Archipelago archipelago(windowSize, islands, population * 4, seed);
+		archipelago.setMigration(interval, rate);
+		archipelago.setPinned(pinned);
+		archipelago.populate(population);
+
+		Clock::time_point start = Clock::now();
+		archipelago.run(ticks);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		unsigned long long migrants = 0, lost = 0;
+		for(unsigned int i = 0; i < islands; ++i)
+		{
+			migrants += archipelago.getEmigrants(i);
+			lost += archipelago.getLost(i);
+		}
+		unsigned long long births = archipelago.getBirths();
+
+		printf("%-8u %10.1f %12.1f %12u %11llu %6llu\n",
+			islands, ticks / seconds, births / seconds, archipelago.getCount(), migrants, lost);
+	}
+	return 0;
+}
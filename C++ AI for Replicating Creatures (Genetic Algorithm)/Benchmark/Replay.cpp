@@ -0,0 +1,175 @@
+// DETERMINISM CHECK: RUNS A WORLD FROM A SEED AND RECORDS OR VERIFIES ITS STATE HASH STREAM
+// record with one build or configuration, verify with another (more threads, grid search
+// instead of neighbour lists, another SIMD kernel...). verifying stops at the first tick that differs and exits with 1.
+// --resume=TICK checks snapshots instead: it saves the world at TICK, runs on, then loads the
+// snapshot into a new pool and runs that one to the end too, both have to hash the same
+//
+//   replay --record=FILE | --verify=FILE | --resume=TICK [--seed=N] [--ticks=N] [--population=N]
+//          [--interval=N] [--threads=N] [--skin=N | --skin=off]
+
+#include "../CreaturePool.h"
+#include "../Snapshot.h"
+#include "../StateHash.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+  // same density as 1000 creatures on a 1280x720 window
+	const float AREA_PER_CREATURE = 1280.f * 720.f / 1000.f;
+
+	bool readOption(const char* arg, const char* name, std::string& value)
+	{
+		size_t length = strlen(name);
+		if(strncmp(arg, name, length) != 0 || arg[length] != '=')
+			return false;
+		value = arg + length + 1;
+		return true;
+	}
+
+	void configure(CreaturePool& pool, ThreadPool& threads, float skin)
+	{
+		pool.setThreadPool(&threads);
+		pool.setNeighbourLists(skin >= 0.f, skin);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long long seed = 1;
+	unsigned int ticks = 2000;
+	unsigned int population = 10000;
+	unsigned int interval = 1;
+	unsigned int threadCount = 1;
+	int resumeTick = -1;
+	float skin = 20.f;
+	std::string recordPath, verifyPath;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string value;
+		if(readOption(argv[i], "--seed", value)) seed = strtoull(value.c_str(), NULL, 10);
+		else if(readOption(argv[i], "--ticks", value)) ticks = atoi(value.c_str());
+		else if(readOption(argv[i], "--population", value)) population = atoi(value.c_str());
+		else if(readOption(argv[i], "--interval", value)) interval = atoi(value.c_str());
+		else if(readOption(argv[i], "--threads", value)) threadCount = atoi(value.c_str());
+		else if(readOption(argv[i], "--skin", value)) skin = (value == "off") ? -1.f : (float)atof(value.c_str());
+		else if(readOption(argv[i], "--record", value)) recordPath = value;
+		else if(readOption(argv[i], "--verify", value)) verifyPath = value;
+		else if(readOption(argv[i], "--resume", value)) resumeTick = atoi(value.c_str());
+		else
+		{
+			recordPath.clear();
+			verifyPath.clear();
+			resumeTick = -1;
+			break;
+		}
+	}
+	if(!recordPath.empty() + !verifyPath.empty() + (resumeTick >= 0) != 1)
+	{
+		fprintf(stderr, "usage: %s --record=FILE | --verify=FILE | --resume=TICK [--seed=N] [--ticks=N] [--population=N] [--interval=N] "
+			"[--threads=N] [--skin=N|off]\n", argv[0]);
+		return 1;
+	}
+
+	StateHash hashes(interval);
+	if(!verifyPath.empty())
+	{
+		std::vector<StateHash::Entry> expected;
+		if(!StateHash::load(verifyPath, expected) || expected.empty())
+		{
+			fprintf(stderr, "can't read %s\n", verifyPath.c_str());
+			return 1;
+		}
+		hashes.expect(expected);
+	}
+
+	float side = sqrtf(population * AREA_PER_CREATURE / (1280.f * 720.f));
+	sf::Vector2u windowSize((unsigned int)(1280 * side), (unsigned int)(720 * side));
+
+	ThreadPool threads(threadCount);
+	Creature::ID = 0;
+	CreaturePool pool(windowSize, population * 2, seed);
+	configure(pool, threads, skin);
+	for(unsigned int i = 0; i < population; ++i)
+		pool.spawn();
+
+	std::vector<char> snapshot;
+	for(unsigned int t = 0; t < ticks && !hashes.hasMismatch(); ++t)
+	{
+		if((int)t == resumeTick)
+			Snapshot::capture(pool, snapshot);
+		pool.tick(1);
+		hashes.record(pool, pool.getTickCount());
+	}
+
+	if(resumeTick >= 0)
+	{
+		if(snapshot.empty())
+		{
+			fprintf(stderr, "the run has no tick %d\n", resumeTick);
+			return 1;
+		}
+		int lastId = Creature::ID;
+		unsigned int lastCount = pool.getCount();
+
+    // THE SECOND POOL STARTS EMPTY AND WITH ANOTHER SEED: EVERYTHING HAS TO COME FROM THE SNAPSHOT
+		CreaturePool resumed(windowSize, population * 2, seed + 1);
+		configure(resumed, threads, skin);
+		if(!Snapshot::restore(resumed, snapshot))
+		{
+			fprintf(stderr, "can't restore the snapshot\n");
+			return 1;
+		}
+
+		std::vector<StateHash::Entry> expected;
+		for(unsigned int i = 0; i < hashes.getStream().size(); ++i)
+			if(hashes.getStream()[i].tick > resumed.getTickCount())
+				expected.push_back(hashes.getStream()[i]);
+		StateHash resumedHashes(interval);
+		resumedHashes.expect(expected);
+		for(unsigned int t = resumeTick; t < ticks && !resumedHashes.hasMismatch(); ++t)
+		{
+			resumed.tick(1);
+			resumedHashes.record(resumed, resumed.getTickCount());
+		}
+
+		if(resumedHashes.hasMismatch() || Creature::ID != lastId || resumed.getCount() != lastCount)
+		{
+			printf("DIFFERENT after resuming at tick %d: from tick %lld on, %u creatures and next id %d instead of %u and %d\n",
+				resumeTick, resumedHashes.getMismatchTick(), resumed.getCount(), Creature::ID, lastCount, lastId);
+			return 1;
+		}
+		printf("same after resuming at tick %d: %u hashes, %u creatures, next id %d\n",
+			resumeTick, resumedHashes.getCheckedCount(), lastCount, lastId);
+		return 0;
+	}
+
+	if(!recordPath.empty())
+	{
+		if(!hashes.save(recordPath))
+		{
+			fprintf(stderr, "can't write %s\n", recordPath.c_str());
+			return 1;
+		}
+		printf("recorded %u hashes, chain %016llx\n", (unsigned int)hashes.getStream().size(), hashes.getChain());
+		return 0;
+	}
+
+	if(hashes.hasMismatch())
+	{
+		printf("DIFFERENT from tick %lld on\n", hashes.getMismatchTick());
+		return 1;
+	}
+	if(hashes.getCheckedCount() < hashes.getExpectedCount())
+	{
+		printf("same for %u hashes, but the recording has %u\n", hashes.getCheckedCount(), hashes.getExpectedCount());
+		return 1;
+	}
+	printf("same: %u hashes, chain %016llx\n", hashes.getCheckedCount(), hashes.getChain());
+	return 0;
+}
@@ -0,0 +1,176 @@
+// HEADLESS BENCHMARK OF A SHARDED WORLD (LINUX)
+// forks one worker process per tile, the workers exchange migrants and halos through
+// shared memory every tick. prints one line per shard and the totals:
+//   ticks per second of the whole world, creatures, ghosts, migrants and births
+//
+//   shardbenchmark [--seed=N] [--ticks=N] [--population=N] [--columns=N] [--rows=N]
+//
+// --columns=1 --rows=1 is the same world in a single process (no exchange at all)
+
+#include "../WorldShard.h"
+#include "../SharedMemoryTransport.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+  // same density as 1000 creatures on a 1280x720 window
+	const float AREA_PER_CREATURE = 1280.f * 720.f / 1000.f;
+	const char* SEGMENT = "/creatures-shards";
+
+	struct Settings
+	{
+		unsigned long long seed;
+		unsigned int ticks;
+		unsigned int population;
+		unsigned int columns;
+		unsigned int rows;
+	};
+
+  // WHAT A WORKER REPORTS BACK THROUGH ITS PIPE
+	struct Result
+	{
+		double seconds;
+		unsigned int count;
+		unsigned int ghosts;
+		unsigned long long migrantsOut;
+		unsigned long long migrantsIn;
+		unsigned long long lost;
+		int births;
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	Result work(const Settings& settings, unsigned int shard)
+	{
+		float side = sqrtf(settings.population * AREA_PER_CREATURE / (1280.f * 720.f));
+		sf::Vector2u windowSize((unsigned int)(1280 * side), (unsigned int)(720 * side));
+		unsigned int shards = settings.columns * settings.rows;
+
+  // ROOM FOR TWICE THE SHARE OF THE POPULATION, PLUS THE HALO
+		unsigned int capacity = settings.population * 2 / shards + settings.population / 4 + 1024;
+
+		Creature::ID = 0;
+		CreaturePool pool(windowSize, capacity, settings.seed);
+		SharedMemoryTransport transport(SEGMENT, shards, shard);
+		WorldShard world(pool, transport.isOpen() ? &transport : NULL, settings.columns, settings.rows, shard);
+		world.populate(settings.population);
+
+		int firstId = Creature::ID;
+		Clock::time_point start = Clock::now();
+		for(unsigned int t = 0; t < settings.ticks; ++t)
+			world.tick(1);
+
+		Result result;
+		memset(&result, 0, sizeof(result));
+		result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		result.count = pool.getCount();
+		result.ghosts = world.getGhostCount();
+		result.migrantsOut = world.getMigrantsOut();
+		result.migrantsIn = world.getMigrantsIn();
+		result.lost = world.getLost();
+		result.births = (Creature::ID - firstId) / (int)shards;
+		return result;
+	}
+
+	bool readOption(const char* arg, const char* name, std::string& value)
+	{
+		size_t length = strlen(name);
+		if(strncmp(arg, name, length) != 0 || arg[length] != '=')
+			return false;
+		value = arg + length + 1;
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Settings settings;
+	settings.seed = 1;
+	settings.ticks = 200;
+	settings.population = 100000;
+	settings.columns = 2;
+	settings.rows = 2;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string value;
+		if(readOption(argv[i], "--seed", value)) settings.seed = strtoull(value.c_str(), NULL, 10);
+		else if(readOption(argv[i], "--ticks", value)) settings.ticks = atoi(value.c_str());
+		else if(readOption(argv[i], "--population", value)) settings.population = atoi(value.c_str());
+		else if(readOption(argv[i], "--columns", value)) settings.columns = std::max(atoi(value.c_str()), 1);
+		else if(readOption(argv[i], "--rows", value)) settings.rows = std::max(atoi(value.c_str()), 1);
+		else
+		{
+			fprintf(stderr, "usage: %s [--seed=N] [--ticks=N] [--population=N] [--columns=N] [--rows=N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	unsigned int shards = settings.columns * settings.rows;
+	SharedMemoryTransport::unlink(SEGMENT);
+
+  // ONE WORKER PER TILE, EACH ONE WRITES ITS RESULT INTO ITS OWN PIPE
+	std::vector<int> pipes(shards);
+	std::vector<pid_t> workers(shards);
+	for(unsigned int s = 0; s < shards; ++s)
+	{
+		int ends[2];
+		if(pipe(ends) != 0)
+			return 1;
+		workers[s] = fork();
+		if(workers[s] == 0)
+		{
+			close(ends[0]);
+			Result result = work(settings, s);
+			bool ok = write(ends[1], &result, sizeof(result)) == (ssize_t)sizeof(result);
+			_exit(ok ? 0 : 1);
+		}
+		close(ends[1]);
+		pipes[s] = ends[0];
+	}
+
+	printf("seed %llu, %u ticks, %u creatures, %ux%u shards\n",
+		settings.seed, settings.ticks, settings.population, settings.columns, settings.rows);
+	printf("%-6s %10s %10s %9s %11s %11s %9s %6s\n", "shard", "ticks/s", "creatures", "ghosts", "moved out", "moved in", "births", "lost");
+
+	Result total;
+	memset(&total, 0, sizeof(total));
+	for(unsigned int s = 0; s < shards; ++s)
+	{
+		Result r;
+		memset(&r, 0, sizeof(r));
+		bool ok = read(pipes[s], &r, sizeof(r)) == (ssize_t)sizeof(r);
+		close(pipes[s]);
+		waitpid(workers[s], NULL, 0);
+		if(!ok)
+		{
+			fprintf(stderr, "shard %u failed\n", s);
+			continue;
+		}
+
+		printf("%-6u %10.1f %10u %9u %11llu %11llu %9d %6llu\n",
+			s, settings.ticks / r.seconds, r.count, r.ghosts, r.migrantsOut, r.migrantsIn, r.births, r.lost);
+		total.seconds = std::max(total.seconds, r.seconds);
+		total.count += r.count;
+		total.ghosts += r.ghosts;
+		total.migrantsOut += r.migrantsOut;
+		total.migrantsIn += r.migrantsIn;
+		total.births += r.births;
+		total.lost += r.lost;
+	}
+	printf("%-6s %10.1f %10u %9u %11llu %11llu %9d %6llu\n",
+		"world", settings.ticks / total.seconds, total.count, total.ghosts, total.migrantsOut, total.migrantsIn, total.births, total.lost);
+
+	SharedMemoryTransport::unlink(SEGMENT);
+	return 0;
+}
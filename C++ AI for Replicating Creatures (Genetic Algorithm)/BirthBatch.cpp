@@ -0,0 +1,60 @@
+#include "BirthBatch.h"
+#include "BirthKernel.h"
+#include "Creature.h"
+#include "CreatureRandom.h"
+
+#include <algorithm>
+
+using BirthKernel::BIRTH_BATCH;
+
+BirthBatch::BirthBatch()
+	: rolls(CreatureRandom::BIRTH_DRAWS * BIRTH_BATCH)
+{
+	genes.reserve(BIRTH_BATCH);
+}
+
+// A PAIR IS DONE, REMEMBER WHAT THE CHILD GETS FROM WHOM
+void BirthBatch::add(const CreatureData& data, Creature* dad, Creature* mum)
+{
+	dads.push_back(dad);
+	mums.push_back(mum);
+	positions.push_back(mum->getPosition());
+	genes.add(data.genes, dad->getSlot(), mum->getSlot());
+}
+
+// GIVE THE FIRST count PAIRS THEIR CHILD (children are initialized, see Creature::init)
+void BirthBatch::create(CreatureData& data, Creature** children, unsigned int count)
+{
+	mutations.assign(count, 0);
+	for(unsigned int base = 0; base < count; base += BIRTH_BATCH)
+	{
+		unsigned int n = std::min(count - base, BIRTH_BATCH);
+		unsigned int slots[BIRTH_BATCH];
+
+    // DICE OF THE BLOCK, ONE COLUMN PER DRAW
+		for(unsigned int i = 0; i < n; ++i)
+		{
+			slots[i] = children[base + i]->getSlot();
+			data.position[slots[i]] = positions[base + i];
+
+			unsigned int roll[CreatureRandom::BIRTH_DRAWS];
+			CreatureRandom(data.seed, children[base + i]->getId()).fill(0, roll, CreatureRandom::BIRTH_DRAWS);
+			for(unsigned int d = 0; d < CreatureRandom::BIRTH_DRAWS; ++d)
+				rolls[d * BIRTH_BATCH + i] = roll[d];
+		}
+
+    // GENE BY GENE: CROSSOVER, WHO MUTATES, THE CHILDREN'S GENES, THE MUTANTS' ROLLS
+		genes.create(data.genes, slots, &rolls[0], base, n, &mutations[base]);
+
+		for(unsigned int i = 0; i < n; ++i)
+			children[base + i]->scheduleLifecycle();
+	}
+}
+
+void BirthBatch::clear()
+{
+	dads.clear();
+	mums.clear();
+	positions.clear();
+	genes.clear();
+}
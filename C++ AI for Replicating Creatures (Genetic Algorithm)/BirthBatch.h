@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "CreatureData.h"
+#include "Genome.h"
+
+class Creature;
+
+// BIRTHS OF ONE TICK, MADE TOGETHER AT THE END OF THE REPLICATION PHASE
+// the parents' genes are gathered as soon as a pair is done (their timers change right
+// after), the children are then made in blocks: every gene is crossed over and rolled for
+// mutation for the whole block at once (BirthKernel), only the few mutants are fixed up
+// one by one. same rules and dice as a single birth, so the result doesn't change.
+// the columns and the code that fills them are generated from the genome (Genome.h)
+class BirthBatch
+{
+private:
+	std::vector<Creature*> dads;
+	std::vector<Creature*> mums;
+	std::vector<sf::Vector2f> positions;
+
+  // per gene: the parents' genes, one entry per pair, and a block of children's
+	Genome::Genes::Columns genes;
+
+  // one block of children: a column per draw of a birth
+	AlignedVector<unsigned int> rolls;
+
+	std::vector<unsigned int> mutations;
+
+public:
+  // constructor
+	BirthBatch();
+
+  // Methods
+	void add(const CreatureData&, Creature* dad, Creature* mum);
+	void create(CreatureData&, Creature** children, unsigned int count);
+	void clear();
+
+  // GETTERS
+	unsigned int getCount() const { return dads.size(); }
+	Creature* getDad(unsigned int i) const { return dads[i]; }
+	Creature* getMum(unsigned int i) const { return mums[i]; }
+	unsigned int getMutations(unsigned int i) const { return mutations[i]; }
+};
@@ -0,0 +1,230 @@
+#include "BirthKernel.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BIRTH_KERNEL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace BirthKernel
+{
+  // x / 100 == (x * 0x51EB851F) >> 37 FOR EVERY 32 BIT x, THAT'S HOW THE SIMD VERSIONS DIVIDE
+	const unsigned int DIV100_MAGIC = 0x51EB851F;
+	const int DIV100_SHIFT = 5;
+
+	void interpolateBatchScalar(const float* dad, const float* mum, float* out, unsigned int count)
+	{
+		for(unsigned int i = 0; i < count; ++i)
+			out[i] = (dad[i] + mum[i]) / 2;
+	}
+
+	void selectBatchScalar(const unsigned int* dad, const unsigned int* mum, const unsigned int* parentRolls,
+		unsigned int* out, unsigned int count)
+	{
+		for(unsigned int i = 0; i < count; ++i)
+			out[i] = (parentRolls[i] % 2 == 0) ? dad[i] : mum[i];
+	}
+
+	unsigned int mutationBatchScalar(const unsigned int* rolls, unsigned int count, unsigned int threshold)
+	{
+		unsigned int mask = 0;
+		for(unsigned int i = 0; i < count; ++i)
+			if(rolls[i] % 100 > threshold)
+				mask |= 1u << i;
+		return mask;
+	}
+
+#ifdef BIRTH_KERNEL_X86
+  // 4 CHILDREN AT ONCE (halving is exact, so * .5f agrees with / 2 bit for bit)
+	void interpolateBatchSSE(const float* dad, const float* mum, float* out, unsigned int count)
+	{
+		__m128 half = _mm_set1_ps(.5f);
+		unsigned int i = 0;
+		for(; i + 4 <= count; i += 4)
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(dad + i), _mm_loadu_ps(mum + i)), half));
+		if(i < count)
+			interpolateBatchScalar(dad + i, mum + i, out + i, count - i);
+	}
+
+	void selectBatchSSE(const unsigned int* dad, const unsigned int* mum, const unsigned int* parentRolls,
+		unsigned int* out, unsigned int count)
+	{
+		__m128i one = _mm_set1_epi32(1);
+		unsigned int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+      // ALL ONES WHERE MUM'S GENE IS TAKEN
+			__m128i fromMum = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)(parentRolls + i)), one), one);
+			__m128i d = _mm_loadu_si128((const __m128i*)(dad + i));
+			__m128i m = _mm_loadu_si128((const __m128i*)(mum + i));
+			_mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(_mm_and_si128(fromMum, m), _mm_andnot_si128(fromMum, d)));
+		}
+		if(i < count)
+			selectBatchScalar(dad + i, mum + i, parentRolls + i, out + i, count - i);
+	}
+
+  // x % 100 OF 4 UNSIGNED LANES (SSE2 HAS NO 32 BIT MULHI, SO EVEN AND ODD LANES GO SEPARATELY)
+	static inline __m128i remainder100SSE(__m128i x)
+	{
+		__m128i magic = _mm_set1_epi32((int)DIV100_MAGIC);
+		__m128i even = _mm_srli_epi64(_mm_mul_epu32(x, magic), 32);
+		__m128i odd = _mm_and_si128(_mm_mul_epu32(_mm_srli_epi64(x, 32), magic), _mm_set_epi32(-1, 0, -1, 0));
+		__m128i q = _mm_srli_epi32(_mm_or_si128(even, odd), DIV100_SHIFT);
+
+    // q * 100 = q * 64 + q * 32 + q * 4
+		__m128i q100 = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(q, 6), _mm_slli_epi32(q, 5)), _mm_slli_epi32(q, 2));
+		return _mm_sub_epi32(x, q100);
+	}
+
+	unsigned int mutationBatchSSE(const unsigned int* rolls, unsigned int count, unsigned int threshold)
+	{
+		__m128i limit = _mm_set1_epi32((int)threshold);
+		unsigned int mask = 0;
+		unsigned int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128i r = remainder100SSE(_mm_loadu_si128((const __m128i*)(rolls + i)));
+			mask |= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(r, limit))) << i;
+		}
+		if(i < count)
+			mask |= mutationBatchScalar(rolls + i, count - i, threshold) << i;
+		return mask;
+	}
+
+  // 8 CHILDREN AT ONCE
+	TARGET_AVX2 void interpolateBatchAVX2(const float* dad, const float* mum, float* out, unsigned int count)
+	{
+		__m256 half = _mm256_set1_ps(.5f);
+		unsigned int i = 0;
+		for(; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(dad + i), _mm256_loadu_ps(mum + i)), half));
+		if(i < count)
+			interpolateBatchSSE(dad + i, mum + i, out + i, count - i);
+	}
+
+	TARGET_AVX2 void selectBatchAVX2(const unsigned int* dad, const unsigned int* mum, const unsigned int* parentRolls,
+		unsigned int* out, unsigned int count)
+	{
+		__m256i one = _mm256_set1_epi32(1);
+		unsigned int i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256i fromMum = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(parentRolls + i)), one), one);
+			__m256i d = _mm256_loadu_si256((const __m256i*)(dad + i));
+			__m256i m = _mm256_loadu_si256((const __m256i*)(mum + i));
+			_mm256_storeu_si256((__m256i*)(out + i), _mm256_blendv_epi8(d, m, fromMum));
+		}
+		if(i < count)
+			selectBatchSSE(dad + i, mum + i, parentRolls + i, out + i, count - i);
+	}
+
+	TARGET_AVX2 static inline __m256i remainder100AVX2(__m256i x)
+	{
+		__m256i magic = _mm256_set1_epi32((int)DIV100_MAGIC);
+		__m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, magic), 32);
+		__m256i odd = _mm256_and_si256(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), magic),
+			_mm256_set_epi32(-1, 0, -1, 0, -1, 0, -1, 0));
+		__m256i q = _mm256_srli_epi32(_mm256_or_si256(even, odd), DIV100_SHIFT);
+		return _mm256_sub_epi32(x, _mm256_mullo_epi32(q, _mm256_set1_epi32(100)));
+	}
+
+	TARGET_AVX2 unsigned int mutationBatchAVX2(const unsigned int* rolls, unsigned int count, unsigned int threshold)
+	{
+		__m256i limit = _mm256_set1_epi32((int)threshold);
+		unsigned int mask = 0;
+		unsigned int i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256i r = remainder100AVX2(_mm256_loadu_si256((const __m256i*)(rolls + i)));
+			mask |= (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(r, limit))) << i;
+		}
+		if(i < count)
+			mask |= mutationBatchSSE(rolls + i, count - i, threshold) << i;
+		return mask;
+	}
+
+	static bool hasAVX2()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if(info[0] < 7) return false;
+		__cpuidex(info, 7, 0);
+		if((info[1] & (1 << 5)) == 0) return false;
+	  // THE OS HAS TO SAVE THE YMM REGISTERS TOO
+		__cpuid(info, 1);
+		if((info[2] & (1 << 27)) == 0) return false;
+		return (_xgetbv(0) & 6) == 6;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+#endif
+
+	typedef void (*InterpolateFunction)(const float*, const float*, float*, unsigned int);
+	typedef void (*SelectFunction)(const unsigned int*, const unsigned int*, const unsigned int*, unsigned int*, unsigned int);
+	typedef unsigned int (*MutationFunction)(const unsigned int*, unsigned int, unsigned int);
+
+	struct Implementation
+	{
+		const char* name;
+		InterpolateFunction interpolate;
+		SelectFunction select;
+		MutationFunction mutation;
+	};
+
+  // RUNTIME DISPATCH
+	static Implementation pick()
+	{
+		Implementation i;
+#ifdef BIRTH_KERNEL_X86
+		if(hasAVX2())
+		{
+			i.name = "avx2";
+			i.interpolate = interpolateBatchAVX2;
+			i.select = selectBatchAVX2;
+			i.mutation = mutationBatchAVX2;
+			return i;
+		}
+		i.name = "sse";
+		i.interpolate = interpolateBatchSSE;
+		i.select = selectBatchSSE;
+		i.mutation = mutationBatchSSE;
+#else
+		i.name = "scalar";
+		i.interpolate = interpolateBatchScalar;
+		i.select = selectBatchScalar;
+		i.mutation = mutationBatchScalar;
+#endif
+		return i;
+	}
+
+	static const Implementation implementation = pick();
+
+	void interpolateBatch(const float* dad, const float* mum, float* out, unsigned int count)
+	{
+		implementation.interpolate(dad, mum, out, count);
+	}
+
+	void selectBatch(const unsigned int* dad, const unsigned int* mum, const unsigned int* parentRolls,
+		unsigned int* out, unsigned int count)
+	{
+		implementation.select(dad, mum, parentRolls, out, count);
+	}
+
+	unsigned int mutationBatch(const unsigned int* rolls, unsigned int count, unsigned int threshold)
+	{
+		return implementation.mutation(rolls, count, threshold);
+	}
+
+	const char* getImplementationName()
+	{
+		return implementation.name;
+	}
+}
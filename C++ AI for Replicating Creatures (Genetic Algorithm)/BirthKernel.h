@@ -0,0 +1,25 @@
+#pragma once
+
+// BATCHED CROSSOVER: ONE GENE OF A BLOCK OF CHILDREN AT ONCE
+// the same rules as a single birth always had:
+//   interpolation  out[i] = (dad[i] + mum[i]) / 2
+//   selection      out[i] = (parentRolls[i] % 2 == 0) ? dad[i] : mum[i]   (any 32 bit gene, bits are copied)
+//   mutation       bit i of the mask is set if rolls[i] % 100 > threshold (95 for every gene so far, see Genome.h)
+// mutation masks cover at most BIRTH_BATCH children, the others take any count
+namespace BirthKernel
+{
+	const unsigned int BIRTH_BATCH = 32;
+
+	void interpolateBatch(const float* dad, const float* mum, float* out, unsigned int count);
+	void selectBatch(const unsigned int* dad, const unsigned int* mum, const unsigned int* parentRolls,
+		unsigned int* out, unsigned int count);
+	unsigned int mutationBatch(const unsigned int* rolls, unsigned int count, unsigned int threshold);
+
+  // plain C++ versions, used as the fallback and for the tails of the SIMD versions
+	void interpolateBatchScalar(const float* dad, const float* mum, float* out, unsigned int count);
+	void selectBatchScalar(const unsigned int* dad, const unsigned int* mum, const unsigned int* parentRolls,
+		unsigned int* out, unsigned int count);
+	unsigned int mutationBatchScalar(const unsigned int* rolls, unsigned int count, unsigned int threshold);
+
+	const char* getImplementationName();
+}
@@ -0,0 +1,128 @@
+#include "CollisionKernel.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define COLLISION_KERNEL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace CollisionKernel
+{
+  // SAME ARITHMETIC IN EVERY VERSION (NO FMA), SO THEY ALL AGREE BIT FOR BIT
+	unsigned int collidesBatchScalar(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count)
+	{
+		unsigned int hits = 0;
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			float dx = cx[i] - x;
+			float dy = cy[i] - y;
+			float range = sightRadius + cr[i];
+			if(dx * dx + dy * dy < range * range)
+				hits |= 1u << i;
+		}
+		return hits;
+	}
+
+#ifdef COLLISION_KERNEL_X86
+  // 4 CANDIDATES AT ONCE
+	unsigned int collidesBatchSSE(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count)
+	{
+		__m128 px = _mm_set1_ps(x);
+		__m128 py = _mm_set1_ps(y);
+		__m128 sight = _mm_set1_ps(sightRadius);
+
+		unsigned int hits = 0;
+		unsigned int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(cx + i), px);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(cy + i), py);
+			__m128 range = _mm_add_ps(sight, _mm_loadu_ps(cr + i));
+			__m128 distance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			hits |= (unsigned int)_mm_movemask_ps(_mm_cmplt_ps(distance2, _mm_mul_ps(range, range))) << i;
+		}
+		if(i < count)
+			hits |= collidesBatchScalar(x, y, sightRadius, cx + i, cy + i, cr + i, count - i) << i;
+		return hits;
+	}
+
+  // 8 CANDIDATES AT ONCE
+	TARGET_AVX2 unsigned int collidesBatchAVX2(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count)
+	{
+		__m256 px = _mm256_set1_ps(x);
+		__m256 py = _mm256_set1_ps(y);
+		__m256 sight = _mm256_set1_ps(sightRadius);
+
+		unsigned int hits = 0;
+		unsigned int i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(cx + i), px);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(cy + i), py);
+			__m256 range = _mm256_add_ps(sight, _mm256_loadu_ps(cr + i));
+			__m256 distance2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+			hits |= (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(distance2, _mm256_mul_ps(range, range), _CMP_LT_OQ)) << i;
+		}
+		if(i < count)
+			hits |= collidesBatchSSE(x, y, sightRadius, cx + i, cy + i, cr + i, count - i) << i;
+		return hits;
+	}
+
+	static bool hasAVX2()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if(info[0] < 7) return false;
+		__cpuidex(info, 7, 0);
+		if((info[1] & (1 << 5)) == 0) return false;
+	  // THE OS HAS TO SAVE THE YMM REGISTERS TOO
+		__cpuid(info, 1);
+		if((info[2] & (1 << 27)) == 0) return false;
+		return (_xgetbv(0) & 6) == 6;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+#endif
+
+  // RUNTIME DISPATCH
+	static BatchFunction pick(const char** name)
+	{
+#ifdef COLLISION_KERNEL_X86
+		if(hasAVX2())
+		{
+			*name = "avx2";
+			return collidesBatchAVX2;
+		}
+		*name = "sse";
+		return collidesBatchSSE;
+#else
+		*name = "scalar";
+		return collidesBatchScalar;
+#endif
+	}
+
+	static const char* implementationName = "";
+	static const BatchFunction implementation = pick(&implementationName);
+
+	unsigned int collidesBatch(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count)
+	{
+		return implementation(x, y, sightRadius, cx, cy, cr, count);
+	}
+
+	const char* getImplementationName()
+	{
+		return implementationName;
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// BATCHED SIGHT TEST: ONE CREATURE AGAINST A BLOCK OF CANDIDATES
+// candidate i is in sight if (x - cx[i])^2 + (y - cy[i])^2 < (sightRadius + cr[i])^2,
+// which is Creature::collides without the bounding box and without sqrtf.
+// count must be <= COLLISION_BATCH, bit i of the result is set for a hit
+namespace CollisionKernel
+{
+	const unsigned int COLLISION_BATCH = 32;
+
+	typedef unsigned int (*BatchFunction)(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count);
+
+  // picks SSE/AVX2/scalar once, depending on the CPU we are running on
+	unsigned int collidesBatch(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count);
+
+  // plain C++ version, used as the fallback and for the tails of the SIMD versions
+	unsigned int collidesBatchScalar(float x, float y, float sightRadius,
+		const float* cx, const float* cy, const float* cr, unsigned int count);
+
+	const char* getImplementationName();
+
+  // INDEX OF THE LOWEST SET BIT (hits must not be 0)
+	inline unsigned int lowestBit(unsigned int hits)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, hits);
+		return index;
+#else
+		return __builtin_ctz(hits);
+#endif
+	}
+}
@@ -1,100 +1,98 @@
 #include "Creature.h"
+#include "SpatialGrid.h"
+#include "NeighbourLists.h"
+#include "CollisionKernel.h"
+#include "CreatureRandom.h"
+#include "Genome.h"
+#include "Profiler.h"
 
-int Creature::ID = 0;
+#include <algorithm>
 
-// CONSTRUCTOR FOR PARENTS (initial creatures)
-Creature::Creature(sf::Vector2u& w)
-	: moveAction(w, position)
+thread_local int Creature::ID = 0;
+thread_local int Creature::ID_STEP = 1;
+
+namespace
 {
-	windowSize = &w;
-	init();
+  // BODY RADIUS AFTER GROWING FOR SO MANY TICKS (+size/10 PER TICK UNTIL IT'S FULL SIZE)
+  // same float steps as when the radius was stored and updated every tick
+	float grownRadius(float size, unsigned int ticks)
+	{
+		float radius = 0.01f;
+		for(unsigned int i = 0; i < ticks && radius < size; ++i)
+			radius += size/10.f;
+		return radius;
+	}
 
-  // RANDOMIZE ATTRIBUTES
-	size = rand()%5 + 10.f;
-	sightRadius = size + rand()%100;
-	
-	position = sf::Vector2f(rand()%windowSize->x, rand()%windowSize->y);
-	
-	body.setFillColor(sf::Color(rand()%255, rand()%255, rand()%255, 200));
-	
-	timeToLive = rand()%10000 + 100;
-	timeToReplicate = rand()%1200 + 200;
-	replicationDuration = rand()%1000 + 200;
-}
-
-// CONSTRUCTOR FOR BABIES (born creatures)
-Creature::Creature(sf::Vector2u& w, Creature* dad, Creature* mum)
-	: moveAction(w, position)
-{
-	windowSize = &w;
-	init();
-  
-  
-  // POSITION OF MUM
-	position = sf::Vector2f(mum->getPosition().x, mum->getPosition().y);
-  
-  // INHERIT CHARACTERISTICS FROM MUM OR DAD CREATURE
+  // FIRST AGE AT WHICH A CREATURE IS DYING (timeToLive IS COMPARED UNSIGNED, LIKE lifeTime)
+	unsigned int dyingAge(int timeToLive)
+	{
+		return std::max((unsigned int)timeToLive, 1u);
+	}
 
-  // SIZE: INTERPOLATION OF MUM AND DAD
-	int mutationRisk = rand()%100;
-	size = (dad->getSize() + mum->getSize()) / 2;
-	if(mutationRisk > 95) size = rand()%5 + 10.f;
+  // AGE AT WHICH THE SHRINKING BODY GETS BELOW .1 -> GONE
+	unsigned int deathAge(float size, int timeToLive)
+	{
+		unsigned int age = dyingAge(timeToLive);
+		if(size <= 0.f)
+			return age;
 
-  // SIGHT: INTERPOLATION OF MUM AND DAD
-	mutationRisk = rand()%100;
-	sightRadius = (dad->getSightRadius() + mum->getSightRadius()) / 2;
-	if(mutationRisk > 95) sightRadius = size + rand()%100;
+		float radius = grownRadius(size, age - 1);
+		for(;; ++age)
+		{
+			radius -= size/10.f;
+			if(radius < .1f)
+				return age;
+		}
+	}
+}
 
-  // COLOR: RANDOM MUM OR DAD
-	mutationRisk = rand()%100;
-	body.setFillColor((rand()%2 == 0) ? dad->getColor() : mum->getColor());
-	if(mutationRisk > 95) body.setFillColor(sf::Color(rand()%255, rand()%255, rand()%255, 200));
+// CONSTRUCTOR (HANDLE ONTO A SLOT, DOESN'T TOUCH THE SLOT ITSELF)
+Creature::Creature(CreatureData& d, unsigned int s)
+	: data(&d), slot(s)
+{
+}
+
+// PARENTS (initial creatures)
+void Creature::randomize()
+{
+	sf::Vector2u* windowSize = data->windowSize;
+	init();
 
-  // LIFETIME: RANDOM MUM OR DAD
-	mutationRisk = rand()%100;
-	timeToLive = (rand()%2 == 0) ? dad->getTTL() : mum->getTTL();
-	if(mutationRisk > 95) timeToLive = rand()%10000 + 100;
+	unsigned int roll[CreatureRandom::BIRTH_DRAWS];
+	CreatureRandom(data->seed, data->id[slot]).fill(0, roll, CreatureRandom::BIRTH_DRAWS);
 
-  // REPLICATION TIMER: RANDOM MUM OR DAD
-	mutationRisk = rand()%100;
-	timeToReplicate = (rand()%2 == 0) ? dad->getTTR() : mum->getTTR();
-	if(mutationRisk > 95) timeToReplicate = rand()%800 + 200;
+  // RANDOMIZE ATTRIBUTES
+	Genome::Genes::randomize(data->genes, slot, Genome::Dice(roll));
+	data->position[slot] = sf::Vector2f(roll[CreatureRandom::POSITION_X]%windowSize->x, roll[CreatureRandom::POSITION_Y]%windowSize->y);
 
-  // REPLICATION DURATION:INTERPOLATION OF MUM AND DAD
-	mutationRisk = rand()%100;
-	replicationDuration = (dad->getReplicationDuration() + mum->getReplicationDuration()) / 2;
-	if(mutationRisk > 95) replicationDuration = rand()%1000 + 200;
+	scheduleLifecycle();
 }
 
 // INIT CREATURE WITH ATTRIBUTES
 void Creature::init()
 {
-	partner = NULL;
-
-	body = sf::CircleShape(0.01f);
-	sight = sf::CircleShape(0.01f);
+	data->partner[slot] = CreatureHandle();
 
-	body.setPosition(position);
-	sight.setPosition(position);
-
-	body.setOutlineColor(sf::Color::White);
-	sight.setFillColor(sf::Color(200, 200, 200, 50));
+	data->state[slot] = CreatureData::ALIVE;
 
-	alive = true;
-	dying = false;
-	replicating = false;
-	movingToPartner = false;
+	data->birth[slot] = data->lifecycle.getNow();
+	data->id[slot] = ID;
+	ID += ID_STEP;
+	data->randomDraws[slot] = CreatureRandom::BIRTH_DRAWS;
 
-	lifeTime = 0;
-	id = ID++;
+  // A RECYCLED SLOT STILL HAS THE OLD TARGET
+	setRandomTargetPosition();
 }
 
 
 // COLLISION WITH OTHER CREATURE
 bool Creature::collides(Creature* c)
 {
+	const sf::Vector2f& position = data->position[slot];
+	float sightRadius = getSightRadius();
 	sf::Vector2f p = c->getPosition();
 	float r = c->getRadius();
+	PROFILE_COUNT(COLLIDES, 1);
   
   // CHECK IF IN SIGHT
 	if ( p.x + r + sightRadius > position.x
@@ -103,6 +101,7 @@ bool Creature::collides(Creature* c)
 		&& p.y < position.y + r + sightRadius)
 	{
     // PYTHAGORAS
+		PROFILE_COUNT(SQRT_TESTS, 1);
 		float distance = sqrtf(
             ((position.x - p.x) * (position.x - p.x))
           + ((position.y - p.y) * (position.y - p.y))
@@ -113,6 +112,8 @@ bool Creature::collides(Creature* c)
 		   return true;
 		}
 	}
+	else
+		PROFILE_COUNT(AABB_REJECTS, 1);
   // NOT IN RANGE
 	return false;
 }
@@ -120,55 +121,313 @@ bool Creature::collides(Creature* c)
 // LOOK OUT FOR A CREATURE THAT IS WILLING TO REPLICATE
 void Creature::searchPartner(std::vector<Creature*>& creatures)
 {
+	const sf::Vector2f& position = data->position[slot];
+
 	for(int i = 0; i < creatures.size(); ++i)
 	{
+		Creature* partner = getPartner();
+
     // I DON'T HAVE A PARTNER YET :(
 		if(partner == NULL || !partner->isReadyToReplicate() || !collides(partner))
 		{
       // FOUND ONE THAT IS LEGIT?
-			if( creatures[i] != this && collides(creatures[i]) 
-				&& creatures[i]->isReadyToReplicate() && !creatures[i]->isReplicating()
-				&& (creatures[i]->getPartner() == NULL || creatures[i]->getPartner() == this))
+			if(canPartnerWith(creatures[i]))
 			{
         // YAY I FOUND A PARTNER -> MOVE TOWARDS PARTNER
-				moveAction.setTargetPosition((creatures[i]->getPosition() + position) / 2.f);
-				sight.setFillColor(sf::Color(255, 255, 0, 100));
-				partner = creatures[i];
-				movingToPartner = true;
+				setTargetPosition((creatures[i]->getPosition() + position) / 2.f);
+				setPartner(creatures[i]);
+				setState(CreatureData::MOVING_TO_PARTNER, true);
 			}
 		} 
     // I ALREADY HAVE A PARTNER :)
     else 
     {
       // MOVE TOWARD CREATURE
-			moveAction.setTargetPosition((partner->getPosition() + position) / 2.f);
-			sight.setFillColor(sf::Color(255, 255, 0, 100));
-			movingToPartner = true;
+			setTargetPosition((partner->getPosition() + position) / 2.f);
+			setState(CreatureData::MOVING_TO_PARTNER, true);
 		}
 	}
-  
-  // UNHIGHLIGHT
-	if(!movingToPartner)
+}
+
+// SAME AS ABOVE, BUT ONLY LOOKS INTO THE 3x3 GRID CELLS AROUND ME
+// picks the candidate with the lowest population index, like the full scan does
+void Creature::searchPartner(SpatialGrid& grid)
+{
+	PartnerProposal proposal;
+	if(proposePartner(grid, proposal))
+		commitPartner(proposal);
+}
+
+// FIRST HALF OF THE GRID SEARCH: ONLY READS, SO ALL CREATURES CAN DO IT AT ONCE
+// returns false if there is nobody to move to
+bool Creature::proposePartner(SpatialGrid& grid, PartnerProposal& proposal)
+{
+	const sf::Vector2f& position = data->position[slot];
+	Creature* partner = getPartner();
+
+	proposal.creature = this;
+
+  // I ALREADY HAVE A PARTNER :)
+	if(partner != NULL && partner->isReadyToReplicate() && collides(partner))
 	{
-		sight.setFillColor(sf::Color(200, 200, 200, 50));
+		proposal.partner = partner;
+		proposal.keep = true;
+		return true;
+	}
+
+  // I DON'T HAVE A PARTNER YET :(
+	unsigned int cells[9];
+	unsigned int cellCount = grid.getNeighbourCells(position, cells);
+
+	Creature* found = NULL;
+	unsigned int foundIndex = 0;
+	for(unsigned int c = 0; c < cellCount; ++c)
+	{
+		unsigned int end = grid.getCellEnd(cells[c]);
+		bool done = false;
+    // ENTRIES OF A CELL ARE IN POPULATION ORDER -> FIRST HIT IS THE BEST OF THIS CELL
+		for(unsigned int begin = grid.getCellBegin(cells[c]); begin < end && !done; begin += CollisionKernel::COLLISION_BATCH)
+		{
+			unsigned int count = std::min(end - begin, CollisionKernel::COLLISION_BATCH);
+			unsigned int hits = CollisionKernel::collidesBatch(position.x, position.y, getSightRadius(),
+				grid.getEntryX() + begin, grid.getEntryY() + begin, grid.getEntryRadius() + begin, count);
+			PROFILE_COUNT(BATCH_TESTS, count);
+
+      // WALK THE HITS IN ORDER
+			while(hits != 0 && !done)
+			{
+				unsigned int i = begin + CollisionKernel::lowestBit(hits);
+				hits &= hits - 1;
+
+				if(found != NULL && grid.getEntryIndex(i) > foundIndex)
+					done = true;
+				else if(grid.getEntry(i)->getSlot() != slot && grid.getEntry(i)->isAvailableFor(this))
+				{
+					found = grid.getEntry(i);
+					foundIndex = grid.getEntryIndex(i);
+					done = true;
+				}
+			}
+		}
+	}
+
+	PROFILE_COUNT(PARTNER_HITS, found != NULL ? 1 : 0);
+	proposal.partner = found;
+	proposal.keep = false;
+	return found != NULL;
+}
+
+// SAME, BUT ONLY FILTERS MY NEIGHBOUR LIST (REBUILT FROM THE GRID IF IT CAN'T BE TRUSTED ANYMORE)
+// the available hit that comes first in the population wins, so it's the one the grid search finds
+bool Creature::proposePartner(SpatialGrid& grid, NeighbourLists& lists, PartnerProposal& proposal)
+{
+	const sf::Vector2f& position = data->position[slot];
+	Creature* partner = getPartner();
+
+	proposal.creature = this;
+
+  // I ALREADY HAVE A PARTNER :)
+	if(partner != NULL && partner->isReadyToReplicate() && collides(partner))
+	{
+		proposal.partner = partner;
+		proposal.keep = true;
+		return true;
+	}
+
+  // I DON'T HAVE A PARTNER YET :(
+	if(!lists.isValid(this))
+	{
+		PROFILE_SCOPE("rebuildNeighbours");
+		lists.rebuild(this, grid);
+	}
+
+	const std::vector<CreatureHandle>& list = lists.getList(slot);
+	float x[CollisionKernel::COLLISION_BATCH];
+	float y[CollisionKernel::COLLISION_BATCH];
+	float r[CollisionKernel::COLLISION_BATCH];
+	Creature* candidates[CollisionKernel::COLLISION_BATCH];
+
+	Creature* found = NULL;
+	unsigned int foundIndex = 0;
+	for(unsigned int next = 0; next < list.size(); )
+	{
+    // GATHER A BATCH OF THE ONES STILL ALIVE (AND BEFORE THE BEST SO FAR)
+		unsigned int count = 0;
+		for(; next < list.size() && count < CollisionKernel::COLLISION_BATCH; ++next)
+		{
+			const CreatureHandle& h = list[next];
+			if(data->generation[h.slot] != h.generation || (found != NULL && data->index[h.slot] > foundIndex))
+				continue;
+			Creature* c = &data->creatures[h.slot];
+			x[count] = c->getPosition().x;
+			y[count] = c->getPosition().y;
+			r[count] = c->getRadius();
+			candidates[count++] = c;
+		}
+
+		unsigned int hits = CollisionKernel::collidesBatch(position.x, position.y, getSightRadius(), x, y, r, count);
+		PROFILE_COUNT(BATCH_TESTS, count);
+
+    // KEEP THE ONE THAT COMES FIRST IN THE POPULATION
+		while(hits != 0)
+		{
+			Creature* c = candidates[CollisionKernel::lowestBit(hits)];
+			hits &= hits - 1;
+			unsigned int index = data->index[c->getSlot()];
+			if((found == NULL || index < foundIndex) && c->isAvailableFor(this))
+			{
+				found = c;
+				foundIndex = index;
+			}
+		}
 	}
+
+	PROFILE_COUNT(PARTNER_HITS, found != NULL ? 1 : 0);
+	proposal.partner = found;
+	proposal.keep = false;
+	return found != NULL;
+}
+
+// SECOND HALF: MOVE TOWARDS THE PARTNER
+// a claim is checked again, somebody committed before me might have taken my partner.
+// returns false if the claim doesn't hold anymore
+bool Creature::commitPartner(const PartnerProposal& proposal)
+{
+	Creature* found = proposal.partner;
+	if(!proposal.keep && !found->isAvailableFor(this))
+		return false;
+
+  // YAY I FOUND A PARTNER -> MOVE TOWARDS PARTNER
+	setTargetPosition((found->getPosition() + data->position[slot]) / 2.f);
+	setPartner(found);
+	setState(CreatureData::MOVING_TO_PARTNER, true);
+	return true;
+}
+
+// IS THAT ONE LEGIT? (IN SIGHT, READY AND NOT TAKEN BY SOMEONE ELSE)
+bool Creature::canPartnerWith(Creature* c)
+{
+	return c->getSlot() != slot && collides(c) && c->isAvailableFor(this);
+}
+
+// AM I READY AND NOT TAKEN BY SOMEONE ELSE?
+bool Creature::isAvailableFor(Creature* c)
+{
+	return isReadyToReplicate() && !isReplicating()
+		&& (getPartner() == NULL || getPartner()->getSlot() == c->getSlot());
+}
+
+// WANDER AROUND (MY OWN DICE, SO THIS IS SAFE FROM ANY THREAD)
+void Creature::setRandomTargetPosition()
+{
+	sf::Vector2u* windowSize = data->windowSize;
+	unsigned int& draws = data->randomDraws[slot];
+	CreatureRandom random(data->seed, data->id[slot]);
+
+	float x = random.at(draws++) % windowSize->x;
+	float y = random.at(draws++) % windowSize->y;
+	setTargetPosition(sf::Vector2f(x, y));
+}
+
+// GO THERE (THE TARGET IS KEPT NEXT TO THE MOVE ACTION SO IT CAN BE SAVED)
+void Creature::setTargetPosition(const sf::Vector2f& p)
+{
+	data->target[slot] = p;
+	data->moveAction[slot].setTargetPosition(p);
 }
 
 // DOESN'T MATTER, HAD SEX
 // SET COOLDOWN FOR NEXT REPLICATION
 void Creature::finishReplicating()
 {
-	partner = NULL;
-	replicating = false;
-	movingToPartner = false;
-	timeToReplicate += lifeTime;
-	moveAction.setRandomTargetPosition();
-	sight.setFillColor(sf::Color(200, 200, 200, 50));
+	data->partner[slot] = CreatureHandle();
+	setState(CreatureData::REPLICATING | CreatureData::MOVING_TO_PARTNER, false);
+	data->genes.get<Genome::TimeToReplicate>()[slot] += getLifeTime();
+	setRandomTargetPosition();
+
+  // READY AGAIN AFTER THE NEW TIMER
+	setState(CreatureData::READY, false);
+	scheduleEvent(LifecycleWheel::READY, (unsigned int)getTTR() + 1);
+}
+
+// BRING THE LIFECYCLE STATE IN LINE WITH MY AGE AND TIMERS AND SCHEDULE WHAT COMES NEXT
+// (after birth, after loading, or after the timers were changed by hand)
+void Creature::scheduleLifecycle()
+{
+	unsigned int age = getLifeTime();
+	unsigned int ready = (unsigned int)getTTR() + 1;
+	unsigned int dying = dyingAge(getTTL());
+	unsigned int dead = deathAge(getSize(), getTTL());
+
+	setState(CreatureData::READY, age >= ready);
+	setState(CreatureData::DYING, age >= dying);
+	setState(CreatureData::ALIVE, age < dead);
+
+	scheduleEvent(LifecycleWheel::READY, ready);
+	scheduleEvent(LifecycleWheel::DYING, dying);
+	scheduleEvent(LifecycleWheel::DEAD, dead);
+}
+
+// SOMETHING HAPPENS AT THAT AGE (NOTHING IF THAT'S NOT IN THE FUTURE)
+void Creature::scheduleEvent(LifecycleWheel::Type type, unsigned int age)
+{
+	if(age <= getLifeTime())
+		return;
+
+	LifecycleWheel::Event e;
+	e.slot = slot;
+	e.generation = data->generation[slot];
+	e.due = data->birth[slot] + age;
+	e.type = (unsigned char)type;
+	data->lifecycle.schedule(e);
+}
+
+// A SCHEDULED EVENT IS DUE. IT MIGHT BE OUTDATED (TIMERS CHANGED), SO CHECK AGAIN
+// returns true if I just died
+bool Creature::handleLifecycle(LifecycleWheel::Type type)
+{
+	unsigned int age = getLifeTime();
+	switch(type)
+	{
+	case LifecycleWheel::READY:
+		if(age > (unsigned int)getTTR())
+			setState(CreatureData::READY, true);
+		return false;
+	case LifecycleWheel::DYING:
+		if(age >= dyingAge(getTTL()))
+			setState(CreatureData::DYING, true);
+		return false;
+	case LifecycleWheel::DEAD:
+		if(!isAlive() || age < deathAge(getSize(), getTTL()))
+			return false;
+		setState(CreatureData::ALIVE, false);
+		return true;
+	}
+	return false;
 }
 
 // CALLED EVERY FRAME
 void Creature::update(int delta)
 {
+	TickBuffer deferred;
+	updateBody(delta, deferred);
+
+	for(unsigned int i = 0; i < deferred.diedPartners.size(); ++i)
+		deferred.diedPartners[i]->partnerDied(); // :(
+
+	updateReplication();
+}
+
+// FIRST HALF OF THE UPDATE: ONLY WRITES TO MYSELF
+// whatever has to happen to others goes into the buffer
+void Creature::updateBody(int delta, TickBuffer& deferred)
+{
+	sf::Vector2u* windowSize = data->windowSize;
+	sf::Vector2f& position = data->position[slot];
+	MoveAction& moveAction = data->moveAction[slot];
+	Creature* partner = getPartner();
+	sf::Vector2f start = position;
+
   // IF POSITION IS OUT OF SCREEN -> TELEPORT TO OPPOSITE SIDE
 	if(position.x < 0.f)
 		position.x += windowSize->x;
@@ -180,71 +439,107 @@ void Creature::update(int delta)
 	else if(position.y > windowSize->y)
 		position.y -= windowSize->y;
 
-  // STILL ALIVE
-	if(++lifeTime < timeToLive)
-	{
-		if(body.getRadius() < size)
-		{
-			body.setRadius(body.getRadius() + size/10.f);
-			sight.setRadius(sight.getRadius() + sightRadius/10.f);
-		}
-	} 
-  // HE'S DEAD, JIM!
-  else 
-  {
-		dying = true;
-		if(partner != NULL) partner->partnerDied(); // :(
-		body.setRadius(body.getRadius() - size/10.f);
-		sight.setRadius(sight.getRadius() + sightRadius/10.f);
-
-		if(body.getRadius() < .1f)
-		{
-			alive = false;
-		}
-	}
-
-  // READY TO REPLICATE ? HIGHTLIGHT IT !
-	if(lifeTime > timeToReplicate)
-		body.setOutlineThickness(2.f);
-	else
-		body.setOutlineThickness(0.f);
+  // HE'S DEAD, JIM! (DYING AND DEATH COME FROM THE LIFECYCLE WHEEL, GROWING AND SHRINKING IS DERIVED FROM THE AGE)
+	if(isDying() && partner != NULL)
+		deferred.diedPartners.push_back(partner);
 
   // STILL ALIVE 
-	if(alive && !dying)
+	if(isAlive() && !isDying())
 	{
     // UPDATE MOVE ACTION
 		moveAction.update();
-		if(moveAction.targetReached() && !replicating)
-			moveAction.setRandomTargetPosition();
-    // REPLICATING ?
-		if(movingToPartner && partner != NULL && moveAction.targetReached(partner->getPosition()))
-			replicating = true;
+		if(moveAction.targetReached() && !hasState(CreatureData::REPLICATING))
+			setRandomTargetPosition();
 	}
 
-  // SET POSITIONS OF CIRCLES
-	body.setPosition(position.x - body.getRadius(), position.y - body.getRadius());
-	sight.setPosition(position.x - sight.getRadius(), position.y - sight.getRadius());
+  // HOW FAR DID I GET (NEIGHBOUR LISTS NEED THE LARGEST STEP OF THE TICK)
+	sf::Vector2f step = position - start;
+	deferred.largestStepSquared = std::max(deferred.largestStepSquared, step.x * step.x + step.y * step.y);
 }
 
+// SECOND HALF, AFTER EVERYBODY MOVED: DID I REACH MY PARTNER?
+void Creature::updateReplication()
+{
+	Creature* partner = getPartner();
+
+  // REPLICATING ?
+	if(isAlive() && !isDying()
+		&& isMovingToPartner() && partner != NULL && data->moveAction[slot].targetReached(partner->getPosition()))
+		setState(CreatureData::REPLICATING, true);
+}
+
+// BODY GROWS BY A TENTH OF ITS SIZE PER TICK UNTIL IT'S FULL SIZE AND SHRINKS THE SAME WAY WHILE DYING
+// derived from the age, the simulation never touches it
+float Creature::getBodyRadius() const
+{
+	float size = data->genes.get<Genome::Size>()[slot];
+	unsigned int lifeTime = getLifeTime();
+	unsigned int dying = dyingAge(data->genes.get<Genome::TimeToLive>()[slot]);
+	if(lifeTime < dying)
+		return grownRadius(size, lifeTime);
+
+	float radius = grownRadius(size, dying - 1);
+	for(unsigned int age = dying; age <= lifeTime; ++age)
+		radius -= size/10.f;
+	return radius;
+}
+
+// SIGHT CIRCLE GROWS WITH THE BODY AND KEEPS GROWING WHILE DYING
+// derived from the age, the simulation never touches it
+float Creature::getSightCircleRadius() const
+{
+	unsigned int lifeTime = getLifeTime();
+	unsigned int timeToLive = data->genes.get<Genome::TimeToLive>()[slot];
+	unsigned int steps = std::min(lifeTime, 10u);
+	if(lifeTime >= timeToLive)
+		steps = std::min(timeToLive, 10u) + lifeTime - timeToLive + 1;
+	return 0.01f + steps * data->genes.get<Genome::SightRadius>()[slot] / 10.f;
+}
+
+#ifndef CREATURES_HEADLESS
 // DRAW THE CIRCLES OF THE CREATURE
+// the shapes are built right here, nothing graphical is kept between frames
 void Creature::draw(sf::RenderWindow& w) const
 {
+	const sf::Vector2f& position = data->position[slot];
+	CreatureColor color = data->genes.get<Genome::Color>()[slot];
+	float bodyRadius = getBodyRadius();
+	float sightCircleRadius = getSightCircleRadius();
+
+	sf::CircleShape sight(sightCircleRadius);
+	sight.setPosition(position.x - sightCircleRadius, position.y - sightCircleRadius);
+  // MOVING TO PARTNER ? HIGHLIGHT IT !
+	if(hasState(CreatureData::MOVING_TO_PARTNER))
+		sight.setFillColor(sf::Color(255, 255, 0, 100));
+	else
+		sight.setFillColor(sf::Color(200, 200, 200, 50));
+
+	sf::CircleShape body(bodyRadius);
+	body.setPosition(position.x - bodyRadius, position.y - bodyRadius);
+	body.setFillColor(sf::Color(color.r, color.g, color.b, color.a));
+	body.setOutlineColor(sf::Color::White);
+  // READY TO REPLICATE ? HIGHTLIGHT IT !
+	if(hasState(CreatureData::READY))
+		body.setOutlineThickness(2.f);
+
 	w.draw(sight);
 	w.draw(body);
 }
+#endif
 
 // GETTER
 bool Creature::isReplicating()
 {
-	return replicating && (lifeTime - timeToReplicate > replicationDuration);
+	return hasState(CreatureData::REPLICATING)
+		&& (getLifeTime() - getTTR() > getReplicationDuration());
 }
 
 // THIS IS JUST AWFUL... 
+// (a partner that is already gone is caught by the generation check, this is for the dying)
 void Creature::partnerDied() 
 { 
-	partner = NULL; 
-	replicating = false;
-	movingToPartner = false;
+	data->partner[slot] = CreatureHandle(); 
+	setState(CreatureData::REPLICATING | CreatureData::MOVING_TO_PARTNER, false);
 }
 
 
@@ -1,81 +1,103 @@
 #pragma once
 
+#include <SFML/System/Vector2.hpp>
+#ifndef CREATURES_HEADLESS
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
-#include <SFML/System/Vector2.hpp>
+#endif
 #include <iostream>
 #include <vector>
 #include <cmath>
 
 
 #include "MoveAction.h"
+#include "CreatureData.h"
+#include "LifecycleWheel.h"
+#include "TickBuffer.h"
 
+class SpatialGrid;
+class NeighbourLists;
+
+// THIN HANDLE ONTO ONE SLOT OF A CREATURE POOL
+// the actual state lives in the arrays of CreatureData
 class Creature
 {
 private:
-	sf::Vector2u* windowSize;
-	Creature* partner;
-
-	sf::CircleShape body;
-	sf::CircleShape sight;
-	sf::Vector2f position;
-	MoveAction moveAction;
-
-	// chromosom relevant parameters
-	float size;
-	float sightRadius;
-	int timeToLive;
-	int timeToReplicate;
-	int replicationDuration;
-
-	unsigned int lifeTime;
-	
-  // states
-	bool alive;
-	bool dying;
-	bool replicating;
-	bool movingToPartner;
-
-  // unique id
-	int id;
+	CreatureData* data;
+	unsigned int slot;
+
+	bool hasState(unsigned char s) const { return (data->state[slot] & s) != 0; }
+	void setState(unsigned char s, bool on) { if(on) data->state[slot] |= s; else data->state[slot] &= ~s; }
+
+	void scheduleEvent(LifecycleWheel::Type, unsigned int age);
 
 public:
-  // static ID counter
-	static int ID;
+  // static ID counter (and how far it moves per creature, sharded worlds interleave their ids)
+  // per thread: every island of an Archipelago hands out its own ids
+	static thread_local int ID;
+	static thread_local int ID_STEP;
 
-  // constructors
-	Creature(sf::Vector2u&);
-	Creature(sf::Vector2u&, Creature*, Creature*);
+  // constructor
+	Creature(CreatureData&, unsigned int slot);
 
   // Methods
 	void init();
+	void randomize();
 	void update(int delta);
+	void updateBody(int delta, TickBuffer&);
+	void updateReplication();
+#ifndef CREATURES_HEADLESS
 	void draw(sf::RenderWindow&) const;
+#endif
 
 	void searchPartner(std::vector<Creature*>&);
-
+	void searchPartner(SpatialGrid&);
+	bool proposePartner(SpatialGrid&, PartnerProposal&);
+	bool proposePartner(SpatialGrid&, NeighbourLists&, PartnerProposal&);
+	bool commitPartner(const PartnerProposal&);
+	bool canPartnerWith(Creature*);
+	bool isAvailableFor(Creature*);
+
+	void setTargetPosition(const sf::Vector2f&);
+	void setRandomTargetPosition();
 	void finishReplicating();
 
+	void scheduleLifecycle();
+	bool handleLifecycle(LifecycleWheel::Type);
+
 	void partnerDied();
-	void setPartner(Creature* p) { partner = p; }
+	void setPartner(Creature* p) { data->partner[slot] = (p != NULL) ? p->getHandle() : CreatureHandle(); }
 
 	bool collides(Creature*);
 
   // GETTERS
-	bool isAlive() { return alive; }
-	bool isDying() { return dying; }
+	bool isAlive() { return hasState(CreatureData::ALIVE); }
+	bool isDying() { return hasState(CreatureData::DYING); }
 	bool isReplicating();
-	bool isMovingToPartner() { return movingToPartner; }
-	bool isReadyToReplicate() { return lifeTime > timeToReplicate; }
-	const sf::Vector2f& getPosition() { return position; }
-	float getRadius() { return size; }
-	float getSightRadius() { return sightRadius; }
-	float getSize() { return size; }
-	sf::Color getColor() { return body.getFillColor(); }
-	int getTTL() { return timeToLive; }
-	int getTTR() { return timeToReplicate; }
-	int getId() { return id; }
-	int getReplicationDuration() { return replicationDuration; }
-	Creature* getPartner() { return partner; }
+	bool isMovingToPartner() { return hasState(CreatureData::MOVING_TO_PARTNER); }
+	bool isReadyToReplicate() { return hasState(CreatureData::READY); }
+	bool isGhost() { return hasState(CreatureData::GHOST); }
+	const sf::Vector2f& getPosition() { return data->position[slot]; }
+	const sf::Vector2f& getTargetPosition() { return data->target[slot]; }
+	float getRadius() { return data->genes.get<Genome::Size>()[slot]; }
+	float getSightRadius() { return data->genes.get<Genome::SightRadius>()[slot]; }
+	float getSize() { return data->genes.get<Genome::Size>()[slot]; }
+	float getBodyRadius() const;
+	float getSightCircleRadius() const;
+	CreatureColor getColor() { return data->genes.get<Genome::Color>()[slot]; }
+	int getTTL() { return data->genes.get<Genome::TimeToLive>()[slot]; }
+	int getTTR() { return data->genes.get<Genome::TimeToReplicate>()[slot]; }
+	int getId() { return data->id[slot]; }
+	int getReplicationDuration() { return data->genes.get<Genome::ReplicationDuration>()[slot]; }
+	template<typename Gene> typename Gene::Value getGene() { return Gene::get(data->genes.get<Gene>()[slot]); }
+	void getGenes(unsigned int* words) { Genome::Genes::save(data->genes, slot, words); }
+	unsigned int getLifeTime() const { return data->lifecycle.getNow() - data->birth[slot]; }
+	Creature* getPartner()
+	{
+		const CreatureHandle& p = data->partner[slot];
+		if(p.isNull() || data->generation[p.slot] != p.generation) return NULL;
+		return &data->creatures[p.slot];
+	}
+	unsigned int getSlot() { return slot; }
+	CreatureHandle getHandle() { return CreatureHandle(slot, data->generation[slot]); }
 };
-
@@ -0,0 +1,15 @@
+#include "CreatureData.h"
+
+CreatureData::CreatureData(sf::Vector2u& w, unsigned int capacity, unsigned long long s)
+	: windowSize(&w), seed(s), creatures(NULL),
+	position(capacity), birth(capacity), state(capacity),
+	generation(capacity), partner(capacity), index(capacity), id(capacity), randomDraws(capacity), target(capacity)
+{
+	Genome::Genes::resize(genes, capacity);
+
+  // EVERY SLOT OWNS ONE MOVE ACTION THAT MOVES ITS POSITION
+  // position is never resized after this, so the references stay valid
+	moveAction.reserve(capacity);
+	for(unsigned int i = 0; i < capacity; ++i)
+		moveAction.push_back(MoveAction(w, position[i]));
+}
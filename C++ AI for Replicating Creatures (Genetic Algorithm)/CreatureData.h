@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "CreatureHandle.h"
+#include "Genome.h"
+#include "LifecycleWheel.h"
+#include "MoveAction.h"
+
+class Creature;
+
+// STRUCTURE OF ARRAYS HOLDING EVERY CREATURE OF A POOL
+// one entry per slot, hot fields are contiguous and cache line aligned
+struct CreatureData
+{
+  // packed state bits
+	enum State
+	{
+		ALIVE = 1 << 0,
+		DYING = 1 << 1,
+		REPLICATING = 1 << 2,
+		MOVING_TO_PARTNER = 1 << 3,
+		READY = 1 << 4,
+		GHOST = 1 << 5
+	};
+
+	sf::Vector2u* windowSize;
+	unsigned long long seed;
+
+  // upcoming lifecycle changes, its tick is the clock ages are measured with
+	LifecycleWheel lifecycle;
+
+  // the pool's per-slot handles (set by the pool)
+	Creature* creatures;
+
+  // a column per gene of Genome::Genes (genes.get<Genome::Size>()), each stored as its Stored type
+  // (quantized with CREATURES_COMPACT, see GeneStorage.h). all but the color are hot
+	Genome::Genes::Table genes;
+
+  // hot: touched by update and partner search every tick
+	AlignedVector<sf::Vector2f> position;
+	AlignedVector<unsigned int> birth;
+	AlignedVector<unsigned char> state;
+	std::vector<unsigned int> generation;
+	std::vector<CreatureHandle> partner;
+
+  // where the creature stands in the pool's population (see CreaturePool::release)
+	std::vector<unsigned int> index;
+
+	static const unsigned int HOT_BYTES = sizeof(sf::Vector2f) + sizeof(Genome::Size::Stored) + sizeof(Genome::SightRadius::Stored)
+		+ sizeof(unsigned int) + sizeof(Genome::TimeToLive::Stored) + sizeof(Genome::TimeToReplicate::Stored)
+		+ sizeof(Genome::ReplicationDuration::Stored) + sizeof(unsigned char)
+		+ sizeof(unsigned int) + sizeof(CreatureHandle) + sizeof(unsigned int);
+
+  // cold
+	std::vector<int> id;
+	std::vector<unsigned int> randomDraws;
+	std::vector<sf::Vector2f> target;
+	std::vector<MoveAction> moveAction;
+
+  // constructor
+	CreatureData(sf::Vector2u&, unsigned int capacity, unsigned long long seed);
+
+private:
+  // move actions point into position, so this must never be copied
+	CreatureData(const CreatureData&);
+	CreatureData& operator=(const CreatureData&);
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+// REFERENCE TO A CREATURE THAT SURVIVES ITS DEATH
+// a slot's generation goes up whenever the slot is given back, so a handle
+// onto a dead creature (or onto whoever got its slot since) is easy to detect
+struct CreatureHandle
+{
+	static const unsigned int NONE = 0xFFFFFFFFu;
+
+	unsigned int slot;
+	unsigned int generation;
+
+	CreatureHandle() : slot(NONE), generation(0) {}
+	CreatureHandle(unsigned int s, unsigned int g) : slot(s), generation(g) {}
+
+	bool isNull() const { return slot == NONE; }
+	bool operator==(const CreatureHandle& h) const { return slot == h.slot && generation == h.generation; }
+	bool operator!=(const CreatureHandle& h) const { return !(*this == h); }
+};
@@ -0,0 +1,372 @@
+#include "CreaturePool.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+CreaturePool::CreaturePool(sf::Vector2u& w, unsigned int c, unsigned long long seed)
+	: windowSize(&w), capacity(c), data(w, c, seed), grid(w), neighbours(c), useNeighbourLists(true), tickCount(0), threads(NULL), buffers(1), events(NULL), stats(NULL)
+{
+  // ONE HANDLE PER SLOT, NEVER REALLOCATED
+	views.reserve(capacity);
+	for(unsigned int i = 0; i < capacity; ++i)
+		views.push_back(Creature(data, i));
+	data.creatures = &views[0];
+
+  // LOWEST SLOTS FIRST, SO THE LIVING CREATURES STAY PACKED AT THE FRONT
+	freeSlots.reserve(capacity);
+	creatures.reserve(capacity);
+	clear();
+}
+
+// KILL EVERYONE, ALL HANDLES GO STALE
+void CreaturePool::clear()
+{
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+		++data.generation[creatures[i]->getSlot()];
+	for(unsigned int i = 0; i < ghosts.size(); ++i)
+		++data.generation[ghosts[i]->getSlot()];
+	creatures.clear();
+	ghosts.clear();
+	if(stats != NULL) stats->clear();
+	dead.clear();
+
+	freeSlots.clear();
+	for(unsigned int i = capacity; i > 0; --i)
+		freeSlots.push_back(i - 1);
+
+	data.lifecycle.clear();
+	neighbours.clear();
+	tickCount = 0;
+}
+
+// RUN THE UPDATE AND PARTNER SEARCH ON THESE THREADS (NULL = ONLY THE CALLING THREAD)
+void CreaturePool::setThreadPool(ThreadPool* t)
+{
+	threads = t;
+	buffers.resize(threads != NULL ? threads->getThreadCount() : 1);
+}
+
+// RECORD BIRTHS AND DEATHS (NULL = OFF)
+// they're logged from the serial parts of a tick, on the thread that calls tick()
+void CreaturePool::setEventLog(EventLog* e)
+{
+	events = e;
+}
+
+// KEEP THESE GENE STATISTICS UP TO DATE AND PUBLISH THEM AFTER EVERY TICK (NULL = OFF)
+// they start from the current population
+void CreaturePool::setGeneStats(GeneStats* s)
+{
+	stats = s;
+	if(stats == NULL)
+		return;
+	stats->clear();
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+		stats->add(creatures[i]);
+	stats->publish(tickCount);
+}
+
+// PARTNER SEARCH THROUGH CACHED NEIGHBOUR LISTS (ON BY DEFAULT) OR THE GRID ALONE
+// both find the same partners, skin is how far beyond sight the lists look
+void CreaturePool::setNeighbourLists(bool enabled, float skin)
+{
+	useNeighbourLists = enabled;
+	neighbours.setSkin(skin);
+}
+
+// PARALLEL LOOP OVER THE POPULATION, ONE CONTIGUOUS CHUNK PER THREAD
+void CreaturePool::forEachCreature(const ThreadPool::Job& job)
+{
+	if(threads != NULL)
+		threads->run(creatures.size(), job);
+	else if(!creatures.empty())
+		job(0, creatures.size(), 0);
+}
+
+// TAKE A FREE SLOT (NULL IF THE POOL IS FULL)
+Creature* CreaturePool::allocate()
+{
+	if(freeSlots.empty())
+		return NULL;
+
+	Creature* c = &views[freeSlots.back()];
+	freeSlots.pop_back();
+	data.index[c->getSlot()] = creatures.size();
+	creatures.push_back(c);
+	return c;
+}
+
+// TAKE SOMEONE OUT OF THE POPULATION IN O(1): THE LAST ONE MOVES INTO ITS PLACE
+// every handle onto it goes stale, nobody else's does (handles don't care where a creature stands)
+void CreaturePool::release(Creature* c)
+{
+	unsigned int slot = c->getSlot();
+	Creature* last = creatures.back();
+	creatures[data.index[slot]] = last;
+	data.index[last->getSlot()] = data.index[slot];
+	creatures.pop_back();
+	if(stats != NULL) stats->remove(c);
+
+	++data.generation[slot];
+	freeSlots.push_back(slot);
+}
+
+// THE POPULATION WAS REARRANGED FROM first ON (BY SOMEONE WHO WALKED IT ANYWAY)
+void CreaturePool::reindex(unsigned int first)
+{
+	for(unsigned int i = first; i < creatures.size(); ++i)
+		data.index[creatures[i]->getSlot()] = i;
+}
+
+// A CREATURE WAS COPIED INTO ITS SLOT (SNAPSHOT, MIGRANT): SCHEDULE ITS LIFECYCLE, IT MIGHT EVEN BE DEAD ALREADY
+void CreaturePool::settle(Creature* c)
+{
+	c->scheduleLifecycle();
+	if(stats != NULL) stats->add(c);
+	if(!c->isAlive())
+		dead.push_back(c->getHandle());
+}
+
+// NEW RANDOM CREATURE
+Creature* CreaturePool::spawn()
+{
+	Creature* c = allocate();
+	if(c == NULL)
+		return NULL;
+
+	c->randomize();
+	if(useNeighbourLists) neighbours.addNewborn(c);
+	if(stats != NULL) stats->add(c);
+	return c;
+}
+
+// NEW BABY (NULL IF THE POOL IS FULL)
+Creature* CreaturePool::spawn(Creature* dad, Creature* mum)
+{
+	unsigned int count = creatures.size();
+	births.add(data, dad, mum);
+	spawnBirths();
+	return (creatures.size() > count) ? creatures.back() : NULL;
+}
+
+// EVERY CHILD OF THE BIRTH BATCH, IN THE ORDER THE PAIRS WERE ADDED (AS MANY AS THERE IS ROOM FOR)
+void CreaturePool::spawnBirths()
+{
+	PROFILE_SCOPE("births");
+	unsigned int first = creatures.size();
+	unsigned int born = 0;
+	for(; born < births.getCount(); ++born)
+	{
+		Creature* c = allocate();
+		if(c == NULL)
+			break;
+		c->init();
+	}
+
+	if(born > 0)
+		births.create(data, &creatures[first], born);
+	for(unsigned int i = 0; i < born; ++i)
+	{
+		Creature* c = creatures[first + i];
+		if(useNeighbourLists) neighbours.addNewborn(c);
+		if(stats != NULL) stats->add(c);
+		if(events != NULL) events->logBirth(tickCount, c, births.getDad(i), births.getMum(i), births.getMutations(i));
+	}
+	PROFILE_COUNT(BIRTHS, born);
+	births.clear();
+}
+
+// ONE SIMULATION STEP
+void CreaturePool::tick(int delta)
+{
+	{
+		PROFILE_SCOPE("tick");
+		update(delta);
+		removeDead();
+		searchPartners();
+		replicate();
+		++tickCount;
+		if(stats != NULL) stats->publish(tickCount);
+	}
+	PROFILE_TICK();
+}
+
+// MOVE, AGE AND ANIMATE EVERYONE
+void CreaturePool::update(int delta)
+{
+	PROFILE_SCOPE("update");
+
+  // EVERYONE GETS A TICK OLDER, ONLY THOSE WITH SOMETHING DUE ARE TOUCHED
+	{
+		PROFILE_SCOPE("lifecycle");
+		dueEvents.clear();
+		data.lifecycle.advance(dueEvents);
+		for(unsigned int i = 0; i < dueEvents.size(); ++i)
+		{
+			const LifecycleWheel::Event& e = dueEvents[i];
+			if(data.generation[e.slot] != e.generation)
+				continue;
+
+			Creature* c = &views[e.slot];
+			if(c->handleLifecycle((LifecycleWheel::Type)e.type))
+			{
+				dead.push_back(c->getHandle());
+				PROFILE_COUNT(DEATHS, 1);
+				if(events != NULL) events->logDeath(tickCount, c);
+			}
+		}
+	}
+
+  // WRAP AND MOVE (ONE SCOPE PER CHUNK, PER CREATURE WOULD COST MORE THAN THE WORK)
+	forEachCreature([this, delta](unsigned int begin, unsigned int end, unsigned int thread)
+	{
+		PROFILE_SCOPE("updateBody");
+		for(unsigned int i = begin; i < end; ++i)
+			creatures[i]->updateBody(delta, buffers[thread]);
+	});
+
+  // CHUNKS ARE IN ORDER, SO THE BUFFERS ARE TOO
+	{
+		PROFILE_SCOPE("partnerDied");
+		float largestStepSquared = 0.f;
+		for(unsigned int t = 0; t < buffers.size(); ++t)
+		{
+			largestStepSquared = std::max(largestStepSquared, buffers[t].largestStepSquared);
+			for(unsigned int i = 0; i < buffers[t].diedPartners.size(); ++i)
+				buffers[t].diedPartners[i]->partnerDied(); // :(
+			buffers[t].clear();
+		}
+		neighbours.addTravel(sqrtf(largestStepSquared));
+	}
+
+	forEachCreature([this](unsigned int begin, unsigned int end, unsigned int)
+	{
+		PROFILE_SCOPE("updateReplication");
+		for(unsigned int i = begin; i < end; ++i)
+			creatures[i]->updateReplication();
+	});
+}
+
+// GIVE THE SLOTS OF THE DEAD BACK, O(DEATHS LOG DEATHS): ONLY THE ONES THAT DIED THIS TICK ARE TOUCHED
+// a death moves the last creature into the empty place. the dead go from the back of the
+// population to the front, so the new order only depends on the order before and on who died:
+// not on the order of the lifecycle events (a loaded snapshot schedules them in another one),
+// not on the number of threads, not on which slot anybody sits in
+void CreaturePool::removeDead()
+{
+	PROFILE_SCOPE("removeDead");
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < dead.size(); ++i)
+	{
+		const CreatureHandle& h = dead[i];
+		if(data.generation[h.slot] == h.generation && !views[h.slot].isAlive())
+			dead[count++] = h;
+	}
+	dead.resize(count);
+
+	const CreatureData& d = data;
+	std::sort(dead.begin(), dead.end(), [&d](const CreatureHandle& a, const CreatureHandle& b)
+	{
+		return d.index[a.slot] > d.index[b.slot];
+	});
+	for(unsigned int i = 0; i < dead.size(); ++i)
+		release(&views[dead[i].slot]);
+	dead.clear();
+}
+
+// PARTNER SEARCH OVER THE GRID
+// everyone proposes at the same time, then the proposals are committed in population
+// order. a claim that got invalid in between falls back to a (serial) fresh search
+void CreaturePool::searchPartners()
+{
+	PROFILE_SCOPE("searchPartners");
+	{
+		PROFILE_SCOPE("gridRebuild");
+
+    // GHOSTS CAN BE FOUND, BUT DON'T SEARCH THEMSELVES
+		std::vector<Creature*>* candidates = &creatures;
+		if(!ghosts.empty())
+		{
+			searchable.assign(creatures.begin(), creatures.end());
+			searchable.insert(searchable.end(), ghosts.begin(), ghosts.end());
+			candidates = &searchable;
+		}
+
+		grid.rebuild(*candidates, useNeighbourLists ? neighbours.getGridMargin() : 0.f);
+		if(useNeighbourLists)
+			neighbours.insertNewborns(*candidates, grid);
+	}
+
+	forEachCreature([this](unsigned int begin, unsigned int end, unsigned int thread)
+	{
+		PROFILE_SCOPE("proposePartner");
+		PartnerProposal proposal;
+		for(unsigned int i = begin; i < end; ++i)
+		{
+			bool proposed = useNeighbourLists ? creatures[i]->proposePartner(grid, neighbours, proposal)
+				: creatures[i]->proposePartner(grid, proposal);
+			if(proposed)
+				buffers[thread].proposals.push_back(proposal);
+		}
+	});
+
+	PROFILE_SCOPE("commitPartner");
+	for(unsigned int t = 0; t < buffers.size(); ++t)
+	{
+		for(unsigned int i = 0; i < buffers[t].proposals.size(); ++i)
+		{
+			const PartnerProposal& proposal = buffers[t].proposals[i];
+			if(!proposal.creature->commitPartner(proposal))
+				proposal.creature->searchPartner(grid);
+		}
+		buffers[t].clear();
+	}
+}
+
+// PAIRS THAT ARE DONE REPLICATING GET A BABY
+void CreaturePool::replicate()
+{
+	PROFILE_SCOPE("replicate");
+  // BABIES ARE APPENDED, DON'T LOOK AT THEM THIS TICK
+	unsigned int count = creatures.size();
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		Creature* mum = creatures[i];
+		Creature* dad = mum->getPartner();
+		if(dad == NULL || !mum->isReplicating() || !dad->isReplicating())
+			continue;
+
+    // PARTNER LIVES IN ANOTHER SHARD: BOTH SIDES SEE THE SAME, THE LOWER ID GETS THE BABY
+		if(dad->isGhost())
+		{
+			if(mum->getId() < dad->getId())
+				births.add(data, dad, mum);
+			finishReplicating(mum);
+			continue;
+		}
+
+		births.add(data, dad, mum);
+		finishReplicating(mum);
+		finishReplicating(dad);
+	}
+	spawnBirths();
+}
+
+// DONE WITH A BABY, THE REPLICATION TIMER (THE ONE CHILDREN INHERIT) MOVES ON
+void CreaturePool::finishReplicating(Creature* c)
+{
+	int before = c->getTTR();
+	c->finishReplicating();
+	if(stats != NULL) stats->change<Genome::TimeToReplicate>(before, c->getTTR());
+}
+
+#ifndef CREATURES_HEADLESS
+// DRAW EVERYONE
+void CreaturePool::draw(sf::RenderWindow& w)
+{
+	PROFILE_SCOPE("draw");
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+		creatures[i]->draw(w);
+}
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#ifndef CREATURES_HEADLESS
+#include <SFML/Graphics.hpp>
+#endif
+#include <vector>
+
+#include "BirthBatch.h"
+#include "Creature.h"
+#include "CreatureData.h"
+#include "EventLog.h"
+#include "GeneStats.h"
+#include "NeighbourLists.h"
+#include "SpatialGrid.h"
+#include "ThreadPool.h"
+#include "TickBuffer.h"
+
+// OWNS ALL CREATURES OF A WORLD
+// storage is allocated once for a fixed capacity, creatures are handed out as
+// pointers to per-slot handles that stay valid for the lifetime of the pool.
+// a tick runs in phases: parallel ones only write to the creature they work on
+// and defer everything else into per-thread buffers, which are then applied in
+// population order. the result doesn't depend on the number of threads
+class CreaturePool
+{
+private:
+	sf::Vector2u* windowSize;
+	unsigned int capacity;
+
+	CreatureData data;
+	std::vector<Creature> views;
+	std::vector<unsigned int> freeSlots;
+
+  // living population. newborns are appended, the last one fills the place of someone who died
+	std::vector<Creature*> creatures;
+
+  // who died this tick (removeDead only touches them)
+	std::vector<CreatureHandle> dead;
+
+  // copies of creatures owned by other shards of a sharded world (WorldShard), partner
+  // search can find them, nothing else touches them. searchable = creatures + ghosts
+	std::vector<Creature*> ghosts;
+	std::vector<Creature*> searchable;
+
+	SpatialGrid grid;
+	NeighbourLists neighbours;
+	bool useNeighbourLists;
+
+	unsigned long long tickCount;
+
+	ThreadPool* threads;
+	std::vector<TickBuffer> buffers;
+
+	EventLog* events;
+	GeneStats* stats;
+
+	std::vector<LifecycleWheel::Event> dueEvents;
+
+  // pairs that are done this tick, their children are born together after the replication phase
+	BirthBatch births;
+
+	Creature* allocate();
+	void release(Creature*);
+	void reindex(unsigned int first);
+	void settle(Creature*);
+	void spawnBirths();
+	void finishReplicating(Creature*);
+	void forEachCreature(const ThreadPool::Job&);
+
+	friend class Snapshot;
+	friend class WorldShard;
+	friend class Archipelago;
+
+public:
+  // constructor
+	CreaturePool(sf::Vector2u&, unsigned int capacity, unsigned long long seed = 0);
+
+  // Methods
+	void setThreadPool(ThreadPool*);
+	void setEventLog(EventLog*);
+	void setGeneStats(GeneStats*);
+	void setNeighbourLists(bool enabled, float skin = 20.f);
+
+	Creature* spawn();
+	Creature* spawn(Creature* dad, Creature* mum);
+
+	void clear();
+
+	void tick(int delta);
+	void update(int delta);
+	void removeDead();
+	void searchPartners();
+	void replicate();
+#ifndef CREATURES_HEADLESS
+	void draw(sf::RenderWindow&);
+#endif
+
+  // GETTERS
+	std::vector<Creature*>& getCreatures() { return creatures; }
+	unsigned int getCount() { return creatures.size(); }
+	unsigned int getCapacity() { return capacity; }
+	bool isFull() { return freeSlots.empty(); }
+	unsigned long long getTickCount() { return tickCount; }
+	CreatureData& getData() { return data; }
+};
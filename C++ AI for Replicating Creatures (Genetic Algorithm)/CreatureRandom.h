@@ -0,0 +1,77 @@
+#pragma once
+
+// COUNTER BASED RANDOM NUMBERS ("SQUARES", WIDYNSKI 2020)
+// a draw is a pure function of (seed, creature id, draw index), so any thread can
+// roll the dice of any creature in any order and still get the same numbers
+class CreatureRandom
+{
+public:
+  // fixed draw indices of a birth, every roll has its own index whether it's used or not
+	enum Draw
+	{
+		SIZE,
+		SIZE_MUTATION,
+		SIGHT,
+		SIGHT_MUTATION,
+		COLOR_PARENT,
+		COLOR_MUTATION,
+		COLOR_R,
+		COLOR_G,
+		COLOR_B,
+		TTL,
+		TTL_PARENT,
+		TTL_MUTATION,
+		TTR,
+		TTR_PARENT,
+		TTR_MUTATION,
+		REPLICATION_DURATION,
+		REPLICATION_DURATION_MUTATION,
+		POSITION_X,
+		POSITION_Y,
+		BIRTH_DRAWS
+	};
+
+private:
+	unsigned long long key;
+	unsigned long long stream;
+
+  // SPLITMIX64, TURNS ANY SEED INTO A USABLE KEY
+	static unsigned long long mix(unsigned long long x)
+	{
+		x += 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	static unsigned long long rotate(unsigned long long x)
+	{
+		return (x >> 32) | (x << 32);
+	}
+
+public:
+  // constructor
+	CreatureRandom(unsigned long long seed, unsigned int creatureId)
+		: key(mix(seed) | 1), stream((unsigned long long)creatureId << 32)
+	{
+	}
+
+  // ONE 32 BIT NUMBER
+	unsigned int at(unsigned int index) const
+	{
+		unsigned long long x = (stream | index) * key;
+		unsigned long long y = x;
+		unsigned long long z = y + key;
+		x = rotate(x * x + y);
+		x = rotate(x * x + z);
+		x = rotate(x * x + y);
+		return (unsigned int)((x * x + z) >> 32);
+	}
+
+  // A BLOCK OF NUMBERS (NO DEPENDENCY BETWEEN ITERATIONS -> THE COMPILER CAN VECTORIZE)
+	void fill(unsigned int first, unsigned int* out, unsigned int count) const
+	{
+		for(unsigned int i = 0; i < count; ++i)
+			out[i] = at(first + i);
+	}
+};
@@ -0,0 +1,49 @@
+#include "CreatureRecord.h"
+#include "Creature.h"
+
+#include <cstring>
+
+CreatureRecord CreatureRecord::capture(CreatureData& data, Creature* c, int partner)
+{
+	unsigned int slot = c->getSlot();
+	CreatureRecord r = CreatureRecord();
+	r.id = data.id[slot];
+	r.partner = partner;
+	r.x = data.position[slot].x;
+	r.y = data.position[slot].y;
+	r.targetX = data.target[slot].x;
+	r.targetY = data.target[slot].y;
+	r.birth = data.birth[slot];
+	r.randomDraws = data.randomDraws[slot];
+	Genome::Genes::save(data.genes, slot, r.genes);
+	r.state = data.state[slot];
+	return r;
+}
+
+CreatureRecord CreatureRecord::read(const char* in)
+{
+	CreatureRecord r;
+	memcpy(&r, in, sizeof(r));
+	return r;
+}
+
+void CreatureRecord::write(std::vector<char>& out) const
+{
+	size_t at = out.size();
+	out.resize(at + sizeof(*this));
+	memcpy(&out[at], this, sizeof(*this));
+}
+
+// FILL A FRESH SLOT (THE PARTNER IS LEFT TO THE CALLER, IT MIGHT NOT BE THERE YET)
+void CreatureRecord::restore(CreatureData& data, Creature* c) const
+{
+	unsigned int slot = c->getSlot();
+	data.id[slot] = id;
+	data.position[slot] = sf::Vector2f(x, y);
+	data.birth[slot] = birth;
+	data.randomDraws[slot] = randomDraws;
+	Genome::Genes::load(data.genes, slot, genes);
+	data.state[slot] = state;
+	c->setPartner(NULL);
+	c->setTargetPosition(sf::Vector2f(targetX, targetY));
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "CreatureData.h"
+#include "Genome.h"
+
+class Creature;
+
+// ONE CREATURE AS PLAIN DATA, ON ITS WAY INTO ANOTHER POOL (A SHARD OR AN ISLAND)
+// host byte order, both ends run on the same kind of machine. birth is a tick of the
+// lifecycle clock, so both pools have to be at the same tick. the partner is an id (-1 = none).
+// the genes are one word each, as the genome saves them (Genome::Genes::save)
+struct CreatureRecord
+{
+	int id;
+	int partner;
+	float x, y;
+	float targetX, targetY;
+	unsigned int birth;
+	unsigned int randomDraws;
+	unsigned int genes[Genome::Genes::COUNT];
+	unsigned char state;
+	unsigned char padding[3];
+
+  // Methods
+	static CreatureRecord capture(CreatureData&, Creature*, int partner);
+	static CreatureRecord read(const char*);
+	void write(std::vector<char>&) const;
+	void restore(CreatureData&, Creature*) const;
+};
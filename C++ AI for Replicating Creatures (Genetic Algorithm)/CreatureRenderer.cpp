@@ -0,0 +1,97 @@
+#include "CreatureRenderer.h"
+
+#ifndef CREATURES_HEADLESS
+
+#include "CreaturePool.h"
+#include "Profiler.h"
+
+#include <cmath>
+
+CreatureRenderer::CreatureRenderer(unsigned int s)
+	: segments(s < 3 ? 3 : s), vertices(sf::Triangles)
+{
+  // CLOSED UNIT CIRCLE (FIRST POINT REPEATED AT THE END)
+	for(unsigned int i = 0; i <= segments; ++i)
+	{
+		float angle = 2.f * 3.14159265f * (i % segments) / segments;
+		unitCircle.push_back(sf::Vector2f(cosf(angle), sinf(angle)));
+	}
+}
+
+// FILLED CIRCLE: ONE TRIANGLE PER SEGMENT
+unsigned int CreatureRenderer::addDisc(unsigned int v, const sf::Vector2f& center, float radius, const sf::Color& color)
+{
+	for(unsigned int i = 0; i < segments; ++i)
+	{
+		vertices[v++] = sf::Vertex(center, color);
+		vertices[v++] = sf::Vertex(center + unitCircle[i] * radius, color);
+		vertices[v++] = sf::Vertex(center + unitCircle[i + 1] * radius, color);
+	}
+	return v;
+}
+
+// OUTLINE OUTSIDE OF THE CIRCLE (LIKE SFML'S OUTLINE): TWO TRIANGLES PER SEGMENT
+unsigned int CreatureRenderer::addRing(unsigned int v, const sf::Vector2f& center, float radius, float thickness, const sf::Color& color)
+{
+	float outer = radius + thickness;
+	for(unsigned int i = 0; i < segments; ++i)
+	{
+		sf::Vector2f a = center + unitCircle[i] * radius;
+		sf::Vector2f b = center + unitCircle[i + 1] * radius;
+		sf::Vector2f c = center + unitCircle[i] * outer;
+		sf::Vector2f d = center + unitCircle[i + 1] * outer;
+		vertices[v++] = sf::Vertex(a, color);
+		vertices[v++] = sf::Vertex(c, color);
+		vertices[v++] = sf::Vertex(b, color);
+		vertices[v++] = sf::Vertex(b, color);
+		vertices[v++] = sf::Vertex(c, color);
+		vertices[v++] = sf::Vertex(d, color);
+	}
+	return v;
+}
+
+// SAME THREAD AS THE SIMULATION: TAKE A FRAME RIGHT NOW
+void CreatureRenderer::draw(sf::RenderWindow& w, CreaturePool& pool)
+{
+	frame.capture(pool);
+	draw(w, frame);
+}
+
+// REBUILD THE VERTICES AND SUBMIT THEM
+void CreatureRenderer::draw(sf::RenderWindow& w, const CreatureFrame& f)
+{
+	PROFILE_SCOPE("draw");
+	unsigned int creatures = f.getCount();
+
+  // COUNT FIRST, SO THE ARRAY IS RESIZED ONCE (IT KEEPS ITS MEMORY BETWEEN FRAMES)
+	unsigned int discVertices = segments * 3;
+	unsigned int ringVertices = segments * 6;
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < creatures; ++i)
+	{
+		count += 2 * discVertices;
+		if(f.flags[i] & CreatureFrame::READY)
+			count += ringVertices;
+	}
+	vertices.resize(count);
+
+	unsigned int v = 0;
+	for(unsigned int i = 0; i < creatures; ++i)
+	{
+		const sf::Vector2f& position = f.position[i];
+		const CreatureColor& color = f.color[i];
+
+    // MOVING TO PARTNER ? HIGHLIGHT IT !
+		v = addDisc(v, position, f.sightRadius[i],
+			(f.flags[i] & CreatureFrame::MOVING_TO_PARTNER) ? sf::Color(255, 255, 0, 100) : sf::Color(200, 200, 200, 50));
+		v = addDisc(v, position, f.bodyRadius[i], sf::Color(color.r, color.g, color.b, color.a));
+
+    // READY TO REPLICATE ? HIGHTLIGHT IT !
+		if(f.flags[i] & CreatureFrame::READY)
+			v = addRing(v, position, f.bodyRadius[i], 2.f, sf::Color::White);
+	}
+
+	w.draw(vertices);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef CREATURES_HEADLESS
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "FrameExchange.h"
+
+class CreaturePool;
+
+// DRAWS A WHOLE POOL WITH ONE DRAW CALL
+// every disc is a fan of triangles from a shared unit circle, scaled per creature.
+// creature by creature: sight, body and (if ready to replicate) the outline ring,
+// so the result looks like calling Creature::draw on everyone.
+// it only ever reads a CreatureFrame, so it can run on another thread than the simulation (RenderThread)
+class CreatureRenderer
+{
+private:
+	unsigned int segments;
+	std::vector<sf::Vector2f> unitCircle;
+	sf::VertexArray vertices;
+	CreatureFrame frame;
+
+	unsigned int addDisc(unsigned int v, const sf::Vector2f& center, float radius, const sf::Color& color);
+	unsigned int addRing(unsigned int v, const sf::Vector2f& center, float radius, float thickness, const sf::Color& color);
+
+public:
+  // constructor
+	CreatureRenderer(unsigned int segments = 16);
+
+  // Methods
+	void draw(sf::RenderWindow&, CreaturePool&);
+	void draw(sf::RenderWindow&, const CreatureFrame&);
+};
+
+#endif
@@ -0,0 +1,385 @@
+#include "EventLog.h"
+#include "Creature.h"
+
+#include <cstring>
+
+#ifdef CREATURES_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+	const char MAGIC[4] = { 'C', 'R', 'E', 'V' };
+
+	void putVarint(std::vector<unsigned char>& out, unsigned long long v)
+	{
+		while(v >= 0x80)
+		{
+			out.push_back((unsigned char)(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back((unsigned char)v);
+	}
+	void putSigned(std::vector<unsigned char>& out, long long v)
+	{
+		putVarint(out, ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63));
+	}
+	void put32(std::vector<unsigned char>& out, unsigned int v)
+	{
+		out.push_back((unsigned char)v);
+		out.push_back((unsigned char)(v >> 8));
+		out.push_back((unsigned char)(v >> 16));
+		out.push_back((unsigned char)(v >> 24));
+	}
+
+  // READING, EVERY GETTER FAILS (FALSE) INSTEAD OF RUNNING OVER THE END
+	struct Reader
+	{
+		const unsigned char* p;
+		const unsigned char* end;
+
+		bool varint(unsigned long long& v)
+		{
+			v = 0;
+			for(unsigned int shift = 0; shift < 64; shift += 7)
+			{
+				if(p == end) return false;
+				unsigned char b = *p++;
+				v |= (unsigned long long)(b & 0x7F) << shift;
+				if(b < 0x80) return true;
+			}
+			return false;
+		}
+		bool sint(long long& v)
+		{
+			unsigned long long u;
+			if(!varint(u)) return false;
+			v = (long long)(u >> 1) ^ -(long long)(u & 1);
+			return true;
+		}
+		bool u32(unsigned int& v)
+		{
+			if(end - p < 4) return false;
+			v = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+			p += 4;
+			return true;
+		}
+		bool byte(unsigned char& b)
+		{
+			if(p == end) return false;
+			b = *p++;
+			return true;
+		}
+	};
+}
+
+EventLog::EventLog(const std::string& path, unsigned int ringCapacity)
+	: file(NULL), ring(ringCapacity), sleeping(false), stopping(false), flushing(false), pushed(0), written(0)
+{
+	block.reserve(BLOCK_RECORDS);
+
+	file = fopen(path.c_str(), "wb");
+	if(file == NULL)
+		return;
+
+	std::vector<unsigned char> header(MAGIC, MAGIC + 4);
+	put32(header, VERSION);
+	fwrite(&header[0], 1, header.size(), file);
+
+	thread = std::thread(&EventLog::work, this);
+}
+
+EventLog::~EventLog()
+{
+	if(file == NULL)
+		return;
+
+	flush();
+	stopping = true;
+	wakeWriter();
+	thread.join();
+	fclose(file);
+}
+
+// ONE RECORD INTO THE RING, WAITS WHILE THE RING IS FULL
+void EventLog::push(const CreatureEvent& e)
+{
+	if(file == NULL)
+		return;
+
+	pushed.fetch_add(1, std::memory_order_relaxed);
+	while(!ring.push(e))
+		std::this_thread::yield();
+
+  // PAIRS WITH THE FENCE IN work: EITHER THE WRITER SEES THE RECORD BEFORE IT SLEEPS, OR WE SEE IT SLEEPING
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(sleeping.load(std::memory_order_relaxed))
+		wakeWriter();
+}
+
+// UNDER THE MUTEX, SO THE WRITER IS EITHER STILL CHECKING WHETHER TO SLEEP OR ALREADY WAITING
+void EventLog::wakeWriter()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	wake.notify_one();
+}
+
+void EventLog::logBirth(unsigned long long tick, Creature* child, Creature* dad, Creature* mum, unsigned int mutations)
+{
+	CreatureEvent e;
+	e.tick = tick;
+	e.id = child->getId();
+	e.dad = dad->getId();
+	e.mum = mum->getId();
+	child->getGenes(e.genes);
+	e.mutations = mutations;
+	e.type = CreatureEvent::BIRTH;
+	push(e);
+}
+
+void EventLog::logDeath(unsigned long long tick, Creature* c)
+{
+	CreatureEvent e;
+	e.tick = tick;
+	e.id = c->getId();
+	e.dad = -1;
+	e.mum = -1;
+	c->getGenes(e.genes);
+	e.mutations = 0;
+	e.type = CreatureEvent::DEATH;
+	push(e);
+}
+
+// WAIT UNTIL EVERYTHING LOGGED SO FAR IS IN THE FILE
+// (call it from the simulation thread, between ticks)
+void EventLog::flush()
+{
+	if(file == NULL)
+		return;
+
+	unsigned long long target = pushed.load();
+	std::unique_lock<std::mutex> lock(mutex);
+	flushing = true;
+	wake.notify_one();
+	while(written < target)
+		drained.wait(lock);
+}
+
+// MOVE WHAT THE RING HAS INTO THE BLOCK (FALSE IF IT WAS EMPTY)
+bool EventLog::drain()
+{
+	bool any = false;
+	CreatureEvent e;
+	while(block.size() < BLOCK_RECORDS && ring.pop(e))
+	{
+		block.push_back(e);
+		any = true;
+	}
+	if(block.size() == BLOCK_RECORDS)
+		writeBlock();
+	return any;
+}
+
+// BACKGROUND THREAD: FULL BLOCKS GO OUT AS SOON AS THEY'RE FULL, A HALF ONE ONLY ON FLUSH
+// (everything flush waits for was pushed before it asked, so the ring is drained by then)
+void EventLog::work()
+{
+	for(;;)
+	{
+		if(drain())
+			continue;
+
+		if(flushing.exchange(false) || stopping)
+		{
+			writeBlock();
+			fflush(file);
+			if(stopping)
+				return;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		sleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while(ring.isEmpty() && !flushing && !stopping)
+			wake.wait(lock);
+		sleeping = false;
+	}
+}
+
+// ENCODE THE BLOCK COLUMN BY COLUMN AND WRITE IT
+void EventLog::writeBlock()
+{
+	if(block.empty())
+		return;
+
+	unsigned int count = block.size();
+	encoded.clear();
+
+  // COLUMNS, SMALL DELTAS -> MOSTLY ONE BYTE PER VALUE
+	for(unsigned int i = 0; i < count; ++i)
+		encoded.push_back(block[i].type);
+
+	unsigned long long lastTick = 0;
+	int lastId = 0;
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		putSigned(encoded, (long long)(block[i].tick - lastTick));
+		lastTick = block[i].tick;
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		putSigned(encoded, (long long)block[i].id - lastId);
+		lastId = block[i].id;
+	}
+
+	for(unsigned int g = 0; g < Genome::Genes::COUNT; ++g)
+	{
+		if(Genome::Genes::getEncoding(g) == Genome::VARINT)
+			for(unsigned int i = 0; i < count; ++i)
+				putSigned(encoded, Genome::Genes::toInteger(g, block[i].genes[g]));
+		else
+			for(unsigned int i = 0; i < count; ++i)
+				put32(encoded, block[i].genes[g]);
+	}
+
+  // BIRTHS ONLY
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		if(block[i].type != CreatureEvent::BIRTH) continue;
+		putSigned(encoded, (long long)block[i].id - block[i].dad);
+		putSigned(encoded, (long long)block[i].id - block[i].mum);
+		putVarint(encoded, block[i].mutations);
+	}
+
+  // DEFLATED IF THAT'S SMALLER (LEVEL 1: THE WRITER HAS TO KEEP UP WITH A FAST SIMULATION)
+	const std::vector<unsigned char>* stored = &encoded;
+#ifdef CREATURES_ZLIB
+	uLongf size = compressBound(encoded.size());
+	compressed.resize(size);
+	if(compress2(&compressed[0], &size, &encoded[0], encoded.size(), 1) == Z_OK && size < encoded.size())
+	{
+		compressed.resize(size);
+		stored = &compressed;
+	}
+#endif
+
+	std::vector<unsigned char> header;
+	put32(header, count);
+	put32(header, encoded.size());
+	put32(header, stored->size());
+	fwrite(&header[0], 1, header.size(), file);
+	fwrite(&(*stored)[0], 1, stored->size(), file);
+	block.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		written += count;
+	}
+	drained.notify_all();
+}
+
+// DECODE A WHOLE FILE
+bool EventLog::readFile(const std::string& path, std::vector<CreatureEvent>& events)
+{
+	events.clear();
+
+	FILE* f = fopen(path.c_str(), "rb");
+	if(f == NULL)
+		return false;
+
+	std::vector<unsigned char> bytes;
+	unsigned char chunk[65536];
+	size_t n;
+	while((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+		bytes.insert(bytes.end(), chunk, chunk + n);
+	fclose(f);
+
+	Reader file = { bytes.empty() ? NULL : &bytes[0], bytes.empty() ? NULL : &bytes[0] + bytes.size() };
+	unsigned int version;
+	if(bytes.size() < 8 || memcmp(&bytes[0], MAGIC, 4) != 0)
+		return false;
+	file.p += 4;
+	if(!file.u32(version) || version != VERSION)
+		return false;
+
+	std::vector<unsigned char> columns;
+	while(file.p != file.end)
+	{
+		unsigned int count, size, stored;
+		if(!file.u32(count) || !file.u32(size) || !file.u32(stored) || (unsigned long long)(file.end - file.p) < stored)
+			return false;
+
+		Reader in = { file.p, file.p + size };
+		if(stored != size)
+		{
+#ifdef CREATURES_ZLIB
+			columns.resize(size);
+			uLongf inflated = size;
+			if(size == 0 || uncompress(&columns[0], &inflated, file.p, stored) != Z_OK || inflated != size)
+				return false;
+			in.p = &columns[0];
+			in.end = &columns[0] + size;
+#else
+			return false;
+#endif
+		}
+		file.p += stored;
+
+		unsigned int first = events.size();
+		events.resize(first + count);
+		CreatureEvent* block = &events[first];
+
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			if(!in.byte(block[i].type)) return false;
+			block[i].dad = -1;
+			block[i].mum = -1;
+			block[i].mutations = 0;
+		}
+
+		long long delta;
+		unsigned long long tick = 0;
+		long long id = 0;
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			if(!in.sint(delta)) return false;
+			block[i].tick = tick += delta;
+		}
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			if(!in.sint(delta)) return false;
+			block[i].id = (int)(id += delta);
+		}
+
+		for(unsigned int g = 0; g < Genome::Genes::COUNT; ++g)
+		{
+			bool varint = Genome::Genes::getEncoding(g) == Genome::VARINT;
+			for(unsigned int i = 0; i < count; ++i)
+			{
+				if(!varint)
+				{
+					if(!in.u32(block[i].genes[g])) return false;
+					continue;
+				}
+				if(!in.sint(delta)) return false;
+				block[i].genes[g] = Genome::Genes::fromInteger(g, delta);
+			}
+		}
+
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			if(block[i].type != CreatureEvent::BIRTH) continue;
+			if(!in.sint(delta)) return false;
+			block[i].dad = (int)(block[i].id - delta);
+			if(!in.sint(delta)) return false;
+			block[i].mum = (int)(block[i].id - delta);
+			unsigned long long mutations;
+			if(!in.varint(mutations)) return false;
+			block[i].mutations = (unsigned int)mutations;
+		}
+
+		if(in.p != in.end)
+			return false;
+	}
+	return true;
+}
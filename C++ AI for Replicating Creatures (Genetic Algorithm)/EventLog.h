@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Genome.h"
+#include "SpscRing.h"
+
+class Creature;
+
+// ONE BIRTH OR DEATH (FIXED SIZE, THAT'S WHAT GOES THROUGH THE RING)
+// dad, mum and mutations are only used by births. the genes are one word each, as the genome
+// saves them (Genome::Genes::save), mutations has bit i set if gene i of Genome::Genes mutated
+struct CreatureEvent
+{
+	enum Type { BIRTH, DEATH };
+
+	unsigned long long tick;
+	int id;
+	int dad;
+	int mum;
+	unsigned int genes[Genome::Genes::COUNT];
+	unsigned int mutations;
+	unsigned char type;
+};
+
+// STREAMS BIRTHS AND DEATHS INTO A COMPACT BINARY FILE
+// the pool logs from the serial parts of a tick (lifecycle events, births), so the simulation
+// thread is the one producer: it pushes into a ring, a background thread drains it and writes
+// blocks. a full ring makes the simulation wait (nothing is lost). the writer sleeps while the
+// ring is empty, the simulation only wakes it when it's asleep.
+//
+// file: "CREV", version, then blocks of [record count][column bytes][stored bytes][stored]:
+//   types (1 byte), ticks and ids (zigzag varint, delta to the previous record),
+//   a column per gene of Genome::Genes in its order, as the gene's ENCODING says (4 bytes, or a
+//   zigzag varint for whole numbers like the timers), and for births only: dad and mum (zigzag
+//   varint, relative to the child), mutations (varint)
+// with CREATURES_ZLIB defined (link zlib) the columns are deflated, a block is stored as it is
+// when that doesn't make it smaller (stored bytes == column bytes). reading a deflated block
+// needs CREATURES_ZLIB too. records are in the order they happened, on any number of threads
+class EventLog
+{
+public:
+	static const unsigned int VERSION = 3;
+	static const unsigned int BLOCK_RECORDS = 4096;
+
+private:
+	FILE* file;
+	SpscRing<CreatureEvent> ring;
+	std::vector<CreatureEvent> block;
+	std::vector<unsigned char> encoded;
+	std::vector<unsigned char> compressed;
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable drained;
+	std::atomic<bool> sleeping;
+	std::atomic<bool> stopping;
+	std::atomic<bool> flushing;
+	std::atomic<unsigned long long> pushed;
+	unsigned long long written;
+
+	void work();
+	bool drain();
+	void writeBlock();
+	void push(const CreatureEvent&);
+	void wakeWriter();
+
+public:
+  // constructor
+	EventLog(const std::string& path, unsigned int ringCapacity = 1 << 16);
+	~EventLog();
+
+  // Methods
+	void logBirth(unsigned long long tick, Creature* child, Creature* dad, Creature* mum, unsigned int mutations);
+	void logDeath(unsigned long long tick, Creature*);
+	void flush();
+
+	static bool readFile(const std::string& path, std::vector<CreatureEvent>& events);
+
+  // GETTERS
+	bool isOpen() const { return file != NULL; }
+
+private:
+	EventLog(const EventLog&);
+	EventLog& operator=(const EventLog&);
+};
@@ -0,0 +1,55 @@
+#include "FastForward.h"
+#include "CreaturePool.h"
+
+FastForward::FastForward(CreaturePool& p)
+	: pool(&p), mode(REAL_TIME), ticksPerFrame(1), framePeriod(std::chrono::milliseconds(100)), ticks(0)
+{
+}
+
+void FastForward::setRealTime()
+{
+	mode = REAL_TIME;
+	ticksPerFrame = 1;
+}
+
+void FastForward::setTicksPerFrame(unsigned int n)
+{
+	mode = TICKS_PER_FRAME;
+	ticksPerFrame = n < 1 ? 1 : n;
+}
+
+void FastForward::setAsFastAsPossible(float renderRate)
+{
+	mode = AS_FAST_AS_POSSIBLE;
+	if(renderRate <= 0.f)
+		renderRate = 10.f;
+	framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.f / renderRate));
+	lastFrame = std::chrono::steady_clock::now();
+}
+
+// RUN THE TICKS OF ONE FRAME, RETURNS HOW MANY
+// (a tick is always one step, no matter how long the frame took)
+unsigned int FastForward::advance()
+{
+	unsigned int n = 0;
+	if(mode == AS_FAST_AS_POSSIBLE)
+	{
+    // AT LEAST ONE TICK, EVEN IF A SINGLE ONE TAKES LONGER THAN A FRAME
+		std::chrono::steady_clock::time_point due = lastFrame + framePeriod;
+		do
+		{
+			pool->tick(1);
+			++n;
+		}
+		while(std::chrono::steady_clock::now() < due);
+		lastFrame = std::chrono::steady_clock::now();
+	}
+	else
+	{
+		for(; n < ticksPerFrame; ++n)
+			pool->tick(1);
+	}
+
+	ticks += n;
+	return n;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+
+class CreaturePool;
+
+// DECOUPLES SIMULATION SPEED FROM THE FRAME RATE
+// call advance() once per displayed frame, it runs the ticks that belong to that frame:
+//   REAL_TIME            one tick per frame (like calling pool.tick directly)
+//   TICKS_PER_FRAME      a fixed number of ticks per frame
+//   AS_FAST_AS_POSSIBLE  ticks until the next frame is due (renderRate frames per second,
+//                        the time spent drawing between two calls counts into the frame)
+// nothing visual is computed during a tick, so the ticks between two frames cost
+// exactly the simulation and nothing else
+class FastForward
+{
+public:
+	enum Mode { REAL_TIME, TICKS_PER_FRAME, AS_FAST_AS_POSSIBLE };
+
+private:
+	CreaturePool* pool;
+	Mode mode;
+	unsigned int ticksPerFrame;
+	std::chrono::steady_clock::duration framePeriod;
+	std::chrono::steady_clock::time_point lastFrame;
+	unsigned long long ticks;
+
+public:
+  // constructor
+	FastForward(CreaturePool&);
+
+  // Methods
+	void setRealTime();
+	void setTicksPerFrame(unsigned int);
+	void setAsFastAsPossible(float renderRate = 10.f);
+
+	unsigned int advance();
+
+  // GETTERS
+	Mode getMode() const { return mode; }
+	unsigned int getTicksPerFrame() const { return ticksPerFrame; }
+	unsigned long long getTicks() const { return ticks; }
+};
@@ -0,0 +1,46 @@
+#include "FrameExchange.h"
+#include "CreaturePool.h"
+#include "Profiler.h"
+
+CreatureFrame::CreatureFrame()
+	: tick(0)
+{
+}
+
+// COPY WHAT'S VISIBLE OF EVERY CREATURE (radii and highlights are derived here, on the simulation thread)
+void CreatureFrame::capture(CreaturePool& pool)
+{
+	std::vector<Creature*>& creatures = pool.getCreatures();
+	unsigned int count = creatures.size();
+	tick = pool.getTickCount();
+	position.resize(count);
+	bodyRadius.resize(count);
+	sightRadius.resize(count);
+	color.resize(count);
+	flags.resize(count);
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		Creature* c = creatures[i];
+		position[i] = c->getPosition();
+		bodyRadius[i] = c->getBodyRadius();
+		sightRadius[i] = c->getSightCircleRadius();
+		color[i] = c->getColor();
+		flags[i] = (c->isMovingToPartner() ? MOVING_TO_PARTNER : 0) | (c->isReadyToReplicate() ? READY : 0);
+	}
+}
+
+FrameExchange::FrameExchange()
+{
+}
+
+// CAPTURE AND PUBLISH, IF THE RENDERER PICKED UP THE LAST FRAME (NO NEED TO CAPTURE MORE THAN IT DRAWS)
+void FrameExchange::publish(CreaturePool& pool)
+{
+	if(!wantsFrame())
+		return;
+
+	PROFILE_SCOPE("captureFrame");
+	getBack().capture(pool);
+	publish();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+#include "GeneStorage.h"
+#include "TripleBuffer.h"
+
+class CreaturePool;
+
+// WHAT THE SCREEN SHOWS OF A POOL AT ONE TICK, NOTHING THE DRAWING CODE HAS TO ASK THE POOL FOR
+class CreatureFrame
+{
+public:
+	enum Flag
+	{
+		MOVING_TO_PARTNER = 1 << 0,
+		READY = 1 << 1
+	};
+
+	unsigned long long tick;
+	std::vector<sf::Vector2f> position;
+	std::vector<float> bodyRadius;
+	std::vector<float> sightRadius;
+	std::vector<CreatureColor> color;
+	std::vector<unsigned char> flags;
+
+  // constructor
+	CreatureFrame();
+
+  // Methods
+	void capture(CreaturePool&);
+
+  // GETTERS
+	unsigned int getCount() const { return position.size(); }
+};
+
+// HANDS FRAMES FROM THE SIMULATION THREAD TO THE RENDER THREAD WITHOUT EITHER EVER WAITING
+// (a TripleBuffer: publishing overwrites a frame the renderer didn't pick up yet, so it
+// always draws the latest one)
+class FrameExchange
+{
+private:
+	TripleBuffer<CreatureFrame> frames;
+
+public:
+  // constructor
+	FrameExchange();
+
+  // SIMULATION SIDE
+	CreatureFrame& getBack() { return frames.getBack(); }
+	void publish() { frames.publish(); }
+	bool wantsFrame() const { return frames.isPickedUp(); }
+	void publish(CreaturePool&);
+
+  // RENDER SIDE (true if there is a newer frame than the one already in front)
+	bool acquire() { return frames.acquire(); }
+	const CreatureFrame& getFront() const { return frames.getFront(); }
+
+private:
+	FrameExchange(const FrameExchange&);
+	FrameExchange& operator=(const FrameExchange&);
+};
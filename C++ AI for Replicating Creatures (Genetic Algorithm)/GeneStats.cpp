@@ -0,0 +1,154 @@
+#include "GeneStats.h"
+#include "Creature.h"
+
+#include <cstring>
+
+namespace
+{
+  // WHERE THE BINS OF EVERY NUMBER START AND HOW WIDE THEY ARE, AS THE GENES SAY
+  // covers everything randomize() and a mutation can roll, the outermost bins take whatever lies beyond
+	struct Ranges
+	{
+		float start[GeneStats::GENE_COUNT];
+		float width[GeneStats::GENE_COUNT];
+
+		Ranges()
+		{
+			for(unsigned int g = 0; g < GeneStats::GENE_COUNT; ++g)
+			{
+				start[g] = Genome::Genes::getStatStart(g);
+				width[g] = Genome::Genes::getStatSpan(g) / GeneStats::BINS;
+			}
+		}
+	};
+
+	const Ranges RANGES;
+}
+
+GeneStats::GeneStats()
+{
+	clear();
+}
+
+void GeneStats::read(Creature* c, float* values)
+{
+	unsigned int genes[Genome::Genes::COUNT];
+	c->getGenes(genes);
+	Genome::Genes::getStats(genes, values);
+}
+
+unsigned int GeneStats::getBin(unsigned int gene, float value)
+{
+	float bin = (value - RANGES.start[gene]) / RANGES.width[gene];
+	return (bin <= 0.f) ? 0 : (bin >= BINS) ? BINS - 1 : (unsigned int)bin;
+}
+
+// A CREATURE JOINED THE POPULATION
+void GeneStats::add(Creature* c)
+{
+	float values[GENE_COUNT];
+	read(c, values);
+
+	++count;
+	double share = 1.0 / count;
+	for(unsigned int g = 0; g < GENE_COUNT; ++g)
+	{
+		Accumulator& a = accumulators[g];
+		double delta = values[g] - a.mean;
+		a.mean += delta * share;
+		a.m2 += delta * (values[g] - a.mean);
+		++a.histogram[getBin(g, values[g])];
+	}
+}
+
+// A CREATURE LEFT THE POPULATION (WITH THE GENES IT HAS NOW, SEE change)
+void GeneStats::remove(Creature* c)
+{
+	if(count <= 1)
+	{
+		clear();
+		return;
+	}
+
+	float values[GENE_COUNT];
+	read(c, values);
+
+	--count;
+	double share = 1.0 / count;
+	for(unsigned int g = 0; g < GENE_COUNT; ++g)
+	{
+		Accumulator& a = accumulators[g];
+		double delta = values[g] - a.mean;
+		a.mean -= delta * share;
+		a.m2 -= delta * (values[g] - a.mean);
+    // ROUNDING CAN TAKE A (NEARLY) UNIFORM GENE JUST BELOW ZERO
+		if(a.m2 < 0.0)
+			a.m2 = 0.0;
+		--a.histogram[getBin(g, values[g])];
+	}
+}
+
+// ONE NUMBER OF SOMEONE IN THE POPULATION WENT FROM before TO after
+void GeneStats::change(unsigned int g, float before, float after)
+{
+	if(count == 0)
+		return;
+
+	Accumulator& a = accumulators[g];
+	double delta = after - before;
+	double mean = a.mean + delta / count;
+	a.m2 += delta * ((after - mean) + (before - a.mean));
+	if(a.m2 < 0.0)
+		a.m2 = 0.0;
+	a.mean = mean;
+	--a.histogram[getBin(g, before)];
+	++a.histogram[getBin(g, after)];
+}
+
+// EMPTY POPULATION (PUBLISHED REPORTS STAY UNTIL THE NEXT publish)
+void GeneStats::clear()
+{
+	count = 0;
+	memset(accumulators, 0, sizeof(accumulators));
+}
+
+// THE CURRENT NUMBERS BECOME THE LATEST REPORT, O(GENES * BINS)
+void GeneStats::publish(unsigned long long tick)
+{
+	Report& r = reports.getBack();
+	r.tick = tick;
+	r.count = count;
+	for(unsigned int g = 0; g < GENE_COUNT; ++g)
+	{
+		const Accumulator& a = accumulators[g];
+		Summary& s = r.genes[g];
+		s.mean = a.mean;
+		s.variance = (count > 0) ? a.m2 / count : 0.0;
+		memcpy(s.histogram, a.histogram, sizeof(s.histogram));
+
+		unsigned int first = 0, last = BINS;
+		while(first < BINS && a.histogram[first] == 0)
+			++first;
+		while(last > first && a.histogram[last - 1] == 0)
+			--last;
+		s.min = (first < last) ? getBinStart(g, first) : 0.f;
+		s.max = (first < last) ? getBinStart(g, last) : 0.f;
+	}
+
+	reports.publish();
+}
+
+const char* GeneStats::getName(unsigned int g)
+{
+	return Genome::Genes::getStatName(g);
+}
+
+float GeneStats::getBinStart(unsigned int g, unsigned int bin)
+{
+	return RANGES.start[g] + bin * RANGES.width[g];
+}
+
+float GeneStats::getBinWidth(unsigned int g)
+{
+	return RANGES.width[g];
+}
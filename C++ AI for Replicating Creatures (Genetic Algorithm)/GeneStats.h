@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Genome.h"
+#include "TripleBuffer.h"
+
+class Creature;
+
+// MEAN, VARIANCE, MIN/MAX AND HISTOGRAM OF EVERY GENE OF A POPULATION, WITHOUT EVER SCANNING IT
+// the pool adds every creature that is born (or moves in) and removes every one that dies (or
+// leaves), each in O(1): Welford's running mean and variance, run backwards for a removal, and
+// one fixed bin per value. min and max are the edges of the outermost bins that aren't empty.
+// the numbers, their names and bins come from Genome::Genes (STATS of every gene, the color has three)
+// the replication timer is the one gene that changes during a life (every baby pushes it
+// further, and that's what children inherit), the pool reports every change()
+// once per tick the numbers are published as a Report, one other thread (a UI, a logger) picks
+// up the latest one (through a TripleBuffer, like the frames of FrameExchange: nobody waits)
+class GeneStats
+{
+public:
+  // the color gene is counted channel by channel
+	static const unsigned int GENE_COUNT = Genome::Genes::STATS;
+	static const unsigned int BINS = 32;
+
+	struct Summary
+	{
+		double mean;
+		double variance;
+		float min;
+		float max;
+		unsigned int histogram[BINS];
+	};
+
+	struct Report
+	{
+		unsigned long long tick;
+		unsigned int count;
+		Summary genes[GENE_COUNT];
+	};
+
+private:
+	struct Accumulator
+	{
+		double mean;
+		double m2;
+		unsigned int histogram[BINS];
+	};
+
+	unsigned int count;
+	Accumulator accumulators[GENE_COUNT];
+
+	TripleBuffer<Report> reports;
+
+	static void read(Creature*, float* values);
+	static unsigned int getBin(unsigned int gene, float value);
+
+	void change(unsigned int gene, float before, float after);
+
+public:
+  // constructor
+	GeneStats();
+
+  // SIMULATION SIDE
+	void add(Creature*);
+	void remove(Creature*);
+	template<typename Gene> void change(typename Gene::Value before, typename Gene::Value after);
+	void clear();
+	void publish(unsigned long long tick);
+
+  // READER SIDE (true if there is a newer report than the one it already has)
+	bool acquire() { return reports.acquire(); }
+	const Report& getReport() const { return reports.getFront(); }
+
+  // GETTERS
+	unsigned int getCount() const { return count; }
+	template<typename Gene> static unsigned int getIndex() { return Genome::Genes::getStatIndex<Gene>(); }
+	static const char* getName(unsigned int gene);
+	static float getBinStart(unsigned int gene, unsigned int bin);
+	static float getBinWidth(unsigned int gene);
+
+private:
+	GeneStats(const GeneStats&);
+	GeneStats& operator=(const GeneStats&);
+};
+
+// ONE GENE OF SOMEONE IN THE POPULATION WENT FROM before TO after
+template<typename Gene>
+void GeneStats::change(typename Gene::Value before, typename Gene::Value after)
+{
+	for(unsigned int s = 0; s < Gene::STATS; ++s)
+		change(getIndex<Gene>() + s, Gene::getStat(before, s), Gene::getStat(after, s));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+
+// RGBA COLOR WITHOUT DEPENDING ON SFML GRAPHICS (HEADLESS BUILDS)
+struct CreatureColor
+{
+	unsigned char r, g, b, a;
+
+	CreatureColor() : r(0), g(0), b(0), a(255) {}
+	CreatureColor(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
+		: r(red), g(green), b(blue), a(alpha) {}
+};
+
+// HOW THE GENES OF A CREATURE ARE STORED (every gene in Genome.h picks one of these as its Stored type)
+// by default as plain floats, ints and RGBA. define CREATURES_COMPACT for huge worlds:
+//   size        8 bit fixed point, 1/16 steps up to 15.9   (sizes are 10..15)
+//   sightRadius 16 bit fixed point, 1/128 steps up to 511  (size + up to 100, more in mutated worlds)
+//   timers      16 bit                                     (lifetimes stay below 10200, replication
+//                                                           timers below twice that)
+//   color       RGB 5:6:5 (a fixed 65536 color palette) + one alpha shared by all creatures (200)
+// the hot state of a creature (position, genes, birth, state, and the generation, partner and
+// population index partner search checks) shrinks from 49 to 38 bytes (CreatureData::HOT_BYTES).
+// values are rounded (and clamped) when they're stored, so a compact world plays out a
+// little differently, but just as deterministic. positions stay float: 16 bit world
+// coordinates would be 2 px steps in a 10M creature world, too coarse for walking. and the
+// color isn't an index into a palette of the population's colors: first generation colors
+// are rolled per channel, nearly every creature would be an override
+#ifdef CREATURES_COMPACT
+
+// FIXED POINT NUMBER THAT READS AND WRITES LIKE A FLOAT
+template<typename T, unsigned int FRACTION_BITS, unsigned int MAX>
+struct FixedPoint
+{
+	T bits;
+
+	FixedPoint& operator=(float f)
+	{
+		float scaled = floorf(f * (1 << FRACTION_BITS) + .5f);
+		bits = (T)((scaled < 0.f) ? 0.f : (scaled > MAX) ? MAX : scaled);
+		return *this;
+	}
+	operator float() const { return bits / (float)(1 << FRACTION_BITS); }
+};
+
+// SMALL UNSIGNED TIMER THAT READS AND WRITES LIKE AN int
+struct ShortTimer
+{
+	unsigned short ticks;
+
+	ShortTimer& operator=(int t)
+	{
+		ticks = (unsigned short)((t < 0) ? 0 : (t > 0xFFFF) ? 0xFFFF : t);
+		return *this;
+	}
+	ShortTimer& operator+=(int t) { return *this = (int)ticks + t; }
+	operator int() const { return ticks; }
+};
+
+// 5:6:5 COLOR, THE ALPHA IS THE SAME FOR EVERY CREATURE
+struct PackedColor
+{
+	static const unsigned char ALPHA = 200;
+
+	unsigned short rgb;
+
+	PackedColor& operator=(const CreatureColor& c)
+	{
+		rgb = (unsigned short)(((c.r >> 3) << 11) | ((c.g >> 2) << 5) | (c.b >> 3));
+		return *this;
+	}
+	operator CreatureColor() const
+	{
+		unsigned int r = (rgb >> 11) & 0x1F, g = (rgb >> 5) & 0x3F, b = rgb & 0x1F;
+		return CreatureColor((unsigned char)((r << 3) | (r >> 2)), (unsigned char)((g << 2) | (g >> 4)),
+			(unsigned char)((b << 3) | (b >> 2)), ALPHA);
+	}
+};
+
+typedef FixedPoint<unsigned char, 4, 0xFF> SizeGene;
+typedef FixedPoint<unsigned short, 7, 0xFFFF> SightGene;
+typedef ShortTimer TimerGene;
+typedef PackedColor ColorGene;
+
+#else
+
+typedef float SizeGene;
+typedef float SightGene;
+typedef int TimerGene;
+typedef CreatureColor ColorGene;
+
+#endif
@@ -0,0 +1,486 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+#include "AlignedAllocator.h"
+#include "BirthKernel.h"
+#include "CreatureRandom.h"
+#include "GeneStorage.h"
+
+// THE GENES OF A CREATURE, EACH DESCRIBED ONCE
+// a gene says how it's stored, the range a first generation creature rolls it from, how a
+// child gets it from its parents, how often it mutates, what a mutant rolls, how the event log
+// writes it and what GeneStats counts of it. Genes lists them in the order they're made (a gene
+// can look at the ones before it), everything that walks the genes is a template over that list:
+// the compiler writes one straight piece of code per gene, there is no table, switch or virtual
+// call left at runtime.
+// a new gene = a struct here, an entry in Genes and its draws in CreatureRandom. its column in
+// CreatureData, births, CreatureRecord, StateHash, the Snapshot sections, the EventLog columns
+// and the GeneStats bins follow Genes by themselves
+namespace Genome
+{
+  // HOW A CHILD GETS A GENE
+	enum Crossover
+	{
+		INTERPOLATE,   // halfway between the parents (Value is a float)
+		PICK_PARENT    // the dad's or the mum's, by a coin flip (Value is 32 bits, copied as they are)
+	};
+
+  // HOW THE EVENT LOG WRITES A GENE (a snapshot always takes 4 bytes, so a mapped file can be indexed)
+	enum Encoding
+	{
+		FIXED,   // 4 bytes, little endian
+		VARINT   // the Value as an int, zigzag varint (small numbers, mostly 1 or 2 bytes)
+	};
+
+  // THE BIRTH DICE OF ONE CREATURE: one number per CreatureRandom::Draw, every stride numbers
+	struct Dice
+	{
+		const unsigned int* rolls;
+		unsigned int stride;
+
+		Dice(const unsigned int* r, unsigned int s = 1) : rolls(r), stride(s) {}
+		unsigned int operator[](unsigned int draw) const { return rolls[draw * stride]; }
+	};
+
+  // A ROLL INTO min..max (BOTH INCLUDED)
+	inline unsigned int inRange(unsigned int roll, unsigned int min, unsigned int max)
+	{
+		return roll % (max - min + 1) + min;
+	}
+
+	inline unsigned int packColor(const CreatureColor& c)
+	{
+		return (unsigned int)c.r | ((unsigned int)c.g << 8) | ((unsigned int)c.b << 16) | ((unsigned int)c.a << 24);
+	}
+
+	inline CreatureColor unpackColor(unsigned int bits)
+	{
+		return CreatureColor(bits & 0xFF, (bits >> 8) & 0xFF, (bits >> 16) & 0xFF, bits >> 24);
+	}
+
+  // A Value AS THE 32 BIT WORD RECORDS, SNAPSHOTS, LOGS AND THE STATE HASH TAKE
+	inline unsigned int toWord(float v)
+	{
+		unsigned int w;
+		memcpy(&w, &v, sizeof(w));
+		return w;
+	}
+	inline unsigned int toWord(unsigned int v) { return v; }
+
+	inline void fromWord(unsigned int w, float& v) { memcpy(&v, &w, sizeof(v)); }
+	inline void fromWord(unsigned int w, unsigned int& v) { v = w; }
+
+  // A Value AS THE WHOLE NUMBER A VARINT TAKES (VARINT GENES ONLY HAVE WHOLE NUMBERS)
+	inline long long toInteger(float v) { return (long long)v; }
+	inline long long toInteger(unsigned int v) { return (int)v; }
+
+	inline void fromInteger(long long i, float& v) { v = (float)i; }
+	inline void fromInteger(long long i, unsigned int& v) { v = (unsigned int)(int)i; }
+
+  // THE COLUMNS OF THE GENES, ONE SLOT PER CREATURE (CreatureData::genes)
+	template<typename Gene> struct GeneColumn
+	{
+		AlignedVector<typename Gene::Stored> values;
+	};
+
+	template<typename... Genes> struct GeneTable : GeneColumn<Genes>...
+	{
+		template<typename Gene> AlignedVector<typename Gene::Stored>& get() { return GeneColumn<Gene>::values; }
+		template<typename Gene> const AlignedVector<typename Gene::Stored>& get() const { return GeneColumn<Gene>::values; }
+	};
+
+  // ONE GENE OF ONE SLOT
+	template<typename Gene, typename Table> typename Gene::Stored& at(Table& genes, unsigned int slot)
+	{
+		return genes.template get<Gene>()[slot];
+	}
+	template<typename Gene, typename Table> const typename Gene::Stored& at(const Table& genes, unsigned int slot)
+	{
+		return genes.template get<Gene>()[slot];
+	}
+
+  // THE GENES
+  // Stored                   how a slot keeps it (smaller with CREATURES_COMPACT, see GeneStorage.h)
+  // Value                    what crossover works on (and what's serialized, one 32 bit word)
+  // get / set                a stored gene as a Value
+  // MIN / MAX                the range random rolls from
+  // random                   a first generation creature's gene
+  // mutate                   a mutant's gene (it mutates if its MUTATION_DRAW % 100 > MUTATION_THRESHOLD)
+  // ENCODING                 how the event log writes it
+  // STATS, getStat(Name)     the numbers GeneStats keeps of it, their bins cover STATS_START .. STATS_START + STATS_SPAN
+	struct Size
+	{
+		typedef SizeGene Stored;
+		typedef float Value;
+		static const Crossover CROSSOVER = INTERPOLATE;
+		static const unsigned int MUTATION_DRAW = CreatureRandom::SIZE_MUTATION;
+		static const unsigned int MUTATION_THRESHOLD = 95;
+		static const unsigned int MIN = 10;
+		static const unsigned int MAX = 14;
+		static const Encoding ENCODING = FIXED;
+		static const unsigned int STATS = 1;
+		static const unsigned int STATS_START = 10;
+		static const unsigned int STATS_SPAN = 5;
+
+		static Value get(const Stored& s) { return s; }
+		static void set(Stored& s, Value v) { s = v; }
+		template<typename Table> static void random(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<Size>(genes, slot) = (float)inRange(roll[CreatureRandom::SIZE], MIN, MAX);
+		}
+		template<typename Table> static void mutate(Table& genes, unsigned int slot, const Dice& roll) { random(genes, slot, roll); }
+		static float getStat(Value v, unsigned int) { return v; }
+		static const char* getStatName(unsigned int) { return "size"; }
+	};
+
+  // (MIN / MAX are on top of the size as it was stored, so a compact world rolls with its rounded size)
+	struct SightRadius
+	{
+		typedef SightGene Stored;
+		typedef float Value;
+		static const Crossover CROSSOVER = INTERPOLATE;
+		static const unsigned int MUTATION_DRAW = CreatureRandom::SIGHT_MUTATION;
+		static const unsigned int MUTATION_THRESHOLD = 95;
+		static const unsigned int MIN = 0;
+		static const unsigned int MAX = 99;
+		static const Encoding ENCODING = FIXED;
+		static const unsigned int STATS = 1;
+		static const unsigned int STATS_START = 0;
+		static const unsigned int STATS_SPAN = 128;
+
+		static Value get(const Stored& s) { return s; }
+		static void set(Stored& s, Value v) { s = v; }
+		template<typename Table> static void random(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<SightRadius>(genes, slot) = (float)at<Size>(genes, slot) + inRange(roll[CreatureRandom::SIGHT], MIN, MAX);
+		}
+		template<typename Table> static void mutate(Table& genes, unsigned int slot, const Dice& roll) { random(genes, slot, roll); }
+		static float getStat(Value v, unsigned int) { return v; }
+		static const char* getStatName(unsigned int) { return "sight"; }
+	};
+
+  // (MIN / MAX are per channel, the alpha is always ALPHA. GeneStats counts the channels apart)
+	struct Color
+	{
+		typedef ColorGene Stored;
+		typedef unsigned int Value;
+		static const Crossover CROSSOVER = PICK_PARENT;
+		static const unsigned int PARENT_DRAW = CreatureRandom::COLOR_PARENT;
+		static const unsigned int MUTATION_DRAW = CreatureRandom::COLOR_MUTATION;
+		static const unsigned int MUTATION_THRESHOLD = 95;
+		static const unsigned int MIN = 0;
+		static const unsigned int MAX = 254;
+		static const unsigned int ALPHA = 200;
+		static const Encoding ENCODING = FIXED;
+		static const unsigned int STATS = 3;
+		static const unsigned int STATS_START = 0;
+		static const unsigned int STATS_SPAN = 256;
+
+		static Value get(const Stored& s) { return packColor(s); }
+		static void set(Stored& s, Value v) { s = unpackColor(v); }
+		template<typename Table> static void random(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<Color>(genes, slot) = CreatureColor(inRange(roll[CreatureRandom::COLOR_R], MIN, MAX), inRange(roll[CreatureRandom::COLOR_G], MIN, MAX),
+				inRange(roll[CreatureRandom::COLOR_B], MIN, MAX), ALPHA);
+		}
+		template<typename Table> static void mutate(Table& genes, unsigned int slot, const Dice& roll) { random(genes, slot, roll); }
+		static float getStat(Value v, unsigned int channel) { return (float)((v >> (8 * channel)) & 0xFF); }
+		static const char* getStatName(unsigned int channel)
+		{
+			static const char* const NAMES[STATS] = { "red", "green", "blue" };
+			return NAMES[channel];
+		}
+	};
+
+	struct TimeToLive
+	{
+		typedef TimerGene Stored;
+		typedef unsigned int Value;
+		static const Crossover CROSSOVER = PICK_PARENT;
+		static const unsigned int PARENT_DRAW = CreatureRandom::TTL_PARENT;
+		static const unsigned int MUTATION_DRAW = CreatureRandom::TTL_MUTATION;
+		static const unsigned int MUTATION_THRESHOLD = 95;
+		static const unsigned int MIN = 100;
+		static const unsigned int MAX = 10099;
+		static const Encoding ENCODING = VARINT;
+		static const unsigned int STATS = 1;
+		static const unsigned int STATS_START = 0;
+		static const unsigned int STATS_SPAN = 10240;
+
+		static Value get(const Stored& s) { return (unsigned int)(int)s; }
+		static void set(Stored& s, Value v) { s = (int)v; }
+		template<typename Table> static void random(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<TimeToLive>(genes, slot) = inRange(roll[CreatureRandom::TTL], MIN, MAX);
+		}
+		template<typename Table> static void mutate(Table& genes, unsigned int slot, const Dice& roll) { random(genes, slot, roll); }
+		static float getStat(Value v, unsigned int) { return (float)(int)v; }
+		static const char* getStatName(unsigned int) { return "ttl"; }
+	};
+
+  // (mutants wait less than the first generation did: they roll from MUTANT_MIN / MUTANT_MAX.
+  // every baby pushes the timer further, so its bins reach twice as far as the ttl's)
+	struct TimeToReplicate
+	{
+		typedef TimerGene Stored;
+		typedef unsigned int Value;
+		static const Crossover CROSSOVER = PICK_PARENT;
+		static const unsigned int PARENT_DRAW = CreatureRandom::TTR_PARENT;
+		static const unsigned int MUTATION_DRAW = CreatureRandom::TTR_MUTATION;
+		static const unsigned int MUTATION_THRESHOLD = 95;
+		static const unsigned int MIN = 200;
+		static const unsigned int MAX = 1399;
+		static const unsigned int MUTANT_MIN = 200;
+		static const unsigned int MUTANT_MAX = 999;
+		static const Encoding ENCODING = VARINT;
+		static const unsigned int STATS = 1;
+		static const unsigned int STATS_START = 0;
+		static const unsigned int STATS_SPAN = 20480;
+
+		static Value get(const Stored& s) { return (unsigned int)(int)s; }
+		static void set(Stored& s, Value v) { s = (int)v; }
+		template<typename Table> static void random(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<TimeToReplicate>(genes, slot) = inRange(roll[CreatureRandom::TTR], MIN, MAX);
+		}
+		template<typename Table> static void mutate(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<TimeToReplicate>(genes, slot) = inRange(roll[CreatureRandom::TTR], MUTANT_MIN, MUTANT_MAX);
+		}
+		static float getStat(Value v, unsigned int) { return (float)(int)v; }
+		static const char* getStatName(unsigned int) { return "ttr"; }
+	};
+
+	struct ReplicationDuration
+	{
+		typedef TimerGene Stored;
+		typedef float Value;
+		static const Crossover CROSSOVER = INTERPOLATE;
+		static const unsigned int MUTATION_DRAW = CreatureRandom::REPLICATION_DURATION_MUTATION;
+		static const unsigned int MUTATION_THRESHOLD = 95;
+		static const unsigned int MIN = 200;
+		static const unsigned int MAX = 1199;
+		static const Encoding ENCODING = VARINT;
+		static const unsigned int STATS = 1;
+		static const unsigned int STATS_START = 0;
+		static const unsigned int STATS_SPAN = 1280;
+
+		static Value get(const Stored& s) { return (float)s; }
+		static void set(Stored& s, Value v) { s = (int)v; }
+		template<typename Table> static void random(Table& genes, unsigned int slot, const Dice& roll)
+		{
+			at<ReplicationDuration>(genes, slot) = inRange(roll[CreatureRandom::REPLICATION_DURATION], MIN, MAX);
+		}
+		template<typename Table> static void mutate(Table& genes, unsigned int slot, const Dice& roll) { random(genes, slot, roll); }
+		static float getStat(Value v, unsigned int) { return v; }
+		static const char* getStatName(unsigned int) { return "duration"; }
+	};
+
+  // CROSSOVER OF ONE GENE FOR A BLOCK OF CHILDREN (rolls: the block's dice, one column per draw)
+	template<Crossover> struct CrossoverOperator;
+
+	template<> struct CrossoverOperator<INTERPOLATE>
+	{
+		template<typename Gene>
+		static void apply(const float* dad, const float* mum, const unsigned int*, float* out, unsigned int count)
+		{
+			BirthKernel::interpolateBatch(dad, mum, out, count);
+		}
+	};
+
+	template<> struct CrossoverOperator<PICK_PARENT>
+	{
+		template<typename Gene>
+		static void apply(const unsigned int* dad, const unsigned int* mum, const unsigned int* rolls, unsigned int* out, unsigned int count)
+		{
+			BirthKernel::selectBatch(dad, mum, rolls + Gene::PARENT_DRAW * BirthKernel::BIRTH_BATCH, out, count);
+		}
+	};
+
+  // EVERYTHING THAT WALKS THE GENES, UNROLLED ONE GENE AT A TIME
+  // (Table is the GeneTable of the whole genome: a gene can look at the genes before it)
+	template<typename... Genes> struct List;
+
+	template<> struct List<>
+	{
+		static const unsigned int COUNT = 0;
+		static const unsigned int STATS = 0;
+
+		template<typename Table> static void resize(Table&, unsigned int) {}
+		template<typename Table> static void randomize(Table&, unsigned int, const Dice&) {}
+		template<typename Table> static void save(const Table&, unsigned int, unsigned int*) {}
+		template<typename Table> static void load(Table&, unsigned int, const unsigned int*) {}
+		static void getStats(const unsigned int*, float*) {}
+
+		static Encoding getEncoding(unsigned int) { return FIXED; }
+		static long long toInteger(unsigned int, unsigned int) { return 0; }
+		static unsigned int fromInteger(unsigned int, long long) { return 0; }
+		static const char* getStatName(unsigned int) { return NULL; }
+		static float getStatStart(unsigned int) { return 0.f; }
+		static float getStatSpan(unsigned int) { return 0.f; }
+		template<typename Gene> static constexpr unsigned int getIndex() { return 0; }
+		template<typename Gene> static constexpr unsigned int getStatIndex() { return 0; }
+
+    // PARENTS' AND CHILDREN'S GENES OF A BIRTH BATCH, A COLUMN EACH PER GENE
+		struct Columns
+		{
+			void reserve(unsigned int) {}
+			template<typename Table> void add(const Table&, unsigned int, unsigned int) {}
+			void clear() {}
+			template<typename Table> void create(Table&, const unsigned int*, const unsigned int*, unsigned int, unsigned int, unsigned int*, unsigned int) {}
+		};
+	};
+
+	template<typename Gene, typename... Rest> struct List<Gene, Rest...>
+	{
+		typedef typename Gene::Value Value;
+		typedef List<Rest...> Next;
+		typedef GeneTable<Gene, Rest...> Table;
+
+		static_assert(sizeof(Value) == sizeof(unsigned int), "a gene is saved as one 32 bit word");
+
+		static const unsigned int COUNT = 1 + Next::COUNT;
+		static const unsigned int STATS = Gene::STATS + Next::STATS;
+
+		template<typename T> static void resize(T& genes, unsigned int capacity)
+		{
+			genes.template get<Gene>().resize(capacity);
+			Next::resize(genes, capacity);
+		}
+
+		template<typename T> static void randomize(T& genes, unsigned int slot, const Dice& roll)
+		{
+			Gene::random(genes, slot, roll);
+			Next::randomize(genes, slot, roll);
+		}
+
+    // ONE WORD PER GENE, IN THE ORDER OF THE LIST (see toWord)
+		template<typename T> static void save(const T& genes, unsigned int slot, unsigned int* words)
+		{
+			words[0] = toWord(Gene::get(at<Gene>(genes, slot)));
+			Next::save(genes, slot, words + 1);
+		}
+
+		template<typename T> static void load(T& genes, unsigned int slot, const unsigned int* words)
+		{
+			Value v;
+			fromWord(words[0], v);
+			Gene::set(at<Gene>(genes, slot), v);
+			Next::load(genes, slot, words + 1);
+		}
+
+    // SAVED WORDS -> THE STATS NUMBERS OF EVERY GENE, IN THE ORDER OF THE LIST
+		static void getStats(const unsigned int* words, float* stats)
+		{
+			Value v;
+			fromWord(words[0], v);
+			for(unsigned int s = 0; s < Gene::STATS; ++s)
+				stats[s] = Gene::getStat(v, s);
+			Next::getStats(words + 1, stats + Gene::STATS);
+		}
+
+    // GENE BY INDEX (FILE FORMATS LOOP OVER THE GENES)
+		static Encoding getEncoding(unsigned int gene)
+		{
+			return (gene == 0) ? Gene::ENCODING : Next::getEncoding(gene - 1);
+		}
+
+		static long long toInteger(unsigned int gene, unsigned int word)
+		{
+			if(gene != 0)
+				return Next::toInteger(gene - 1, word);
+			Value v;
+			fromWord(word, v);
+			return Genome::toInteger(v);
+		}
+
+		static unsigned int fromInteger(unsigned int gene, long long i)
+		{
+			if(gene != 0)
+				return Next::fromInteger(gene - 1, i);
+			Value v;
+			Genome::fromInteger(i, v);
+			return toWord(v);
+		}
+
+    // STATS NUMBER BY INDEX
+		static const char* getStatName(unsigned int stat)
+		{
+			return (stat < Gene::STATS) ? Gene::getStatName(stat) : Next::getStatName(stat - Gene::STATS);
+		}
+
+		static float getStatStart(unsigned int stat)
+		{
+			return (stat < Gene::STATS) ? (float)Gene::STATS_START : Next::getStatStart(stat - Gene::STATS);
+		}
+
+		static float getStatSpan(unsigned int stat)
+		{
+			return (stat < Gene::STATS) ? (float)Gene::STATS_SPAN : Next::getStatSpan(stat - Gene::STATS);
+		}
+
+    // WHERE A GENE IS IN THE LIST, AND WHERE ITS FIRST STATS NUMBER IS
+		template<typename G> static constexpr unsigned int getIndex()
+		{
+			return std::is_same<G, Gene>::value ? 0 : 1 + Next::template getIndex<G>();
+		}
+
+		template<typename G> static constexpr unsigned int getStatIndex()
+		{
+			return std::is_same<G, Gene>::value ? 0 : Gene::STATS + Next::template getStatIndex<G>();
+		}
+
+		struct Columns : Next::Columns
+		{
+			AlignedVector<Value> dad, mum;
+			AlignedVector<Value> child;
+
+			void reserve(unsigned int block)
+			{
+				child.resize(block);
+				Next::Columns::reserve(block);
+			}
+
+			template<typename T> void add(const T& genes, unsigned int dadSlot, unsigned int mumSlot)
+			{
+				dad.push_back(Gene::get(at<Gene>(genes, dadSlot)));
+				mum.push_back(Gene::get(at<Gene>(genes, mumSlot)));
+				Next::Columns::add(genes, dadSlot, mumSlot);
+			}
+
+			void clear()
+			{
+				dad.clear();
+				mum.clear();
+				Next::Columns::clear();
+			}
+
+      // PAIRS first.. first + count - 1 GET THEIR CHILD'S GENE: CROSSOVER AND MUTATION FOR THE
+      // WHOLE BLOCK, THEN THE FEW MUTANTS ROLL THEIR OWN (AND GET bit IN THEIR MUTATIONS, bit << 1 IS THE NEXT GENE'S)
+			template<typename T> void create(T& genes, const unsigned int* slots, const unsigned int* rolls,
+				unsigned int first, unsigned int count, unsigned int* mutations, unsigned int bit = 1)
+			{
+				CrossoverOperator<Gene::CROSSOVER>::template apply<Gene>(&dad[first], &mum[first], rolls, &child[0], count);
+				unsigned int mutants = BirthKernel::mutationBatch(rolls + Gene::MUTATION_DRAW * BirthKernel::BIRTH_BATCH,
+					count, Gene::MUTATION_THRESHOLD);
+
+				for(unsigned int i = 0; i < count; ++i)
+					Gene::set(at<Gene>(genes, slots[i]), child[i]);
+				for(unsigned int i = 0; mutants != 0; ++i, mutants >>= 1)
+				{
+					if((mutants & 1) == 0)
+						continue;
+					Gene::mutate(genes, slots[i], Dice(rolls + i, BirthKernel::BIRTH_BATCH));
+					mutations[i] |= bit;
+				}
+
+				Next::Columns::create(genes, slots, rolls, first, count, mutations, bit << 1);
+			}
+		};
+	};
+
+  // THE GENOME, IN THE ORDER THE GENES ARE MADE (sight rolls after size)
+	typedef List<Size, SightRadius, Color, TimeToLive, TimeToReplicate, ReplicationDuration> Genes;
+}
@@ -0,0 +1,59 @@
+#include "LifecycleWheel.h"
+
+LifecycleWheel::LifecycleWheel()
+	: now(0), count(0)
+{
+}
+
+// DROP EVERYTHING AND START OVER AT THAT TICK
+void LifecycleWheel::clear(unsigned int n)
+{
+	for(unsigned int l = 0; l < LEVELS; ++l)
+		for(unsigned int b = 0; b < BUCKETS; ++b)
+			buckets[l][b].clear();
+	now = n;
+	count = 0;
+}
+
+// LOWEST LEVEL ON WHICH DUE AND NOW ONLY DIFFER IN THE BITS OF THAT LEVEL
+void LifecycleWheel::insert(const Event& e)
+{
+	unsigned int difference = e.due ^ now;
+	unsigned int level = 0;
+	while(level < LEVELS - 1 && (difference >> (BITS * (level + 1))) != 0)
+		++level;
+	buckets[level][(e.due >> (BITS * level)) & (BUCKETS - 1)].push_back(e);
+}
+
+// EVENT IN THE FUTURE (EVENTS FOR NOW OR THE PAST ARE IGNORED, THEY'D NEVER FIRE)
+void LifecycleWheel::schedule(const Event& e)
+{
+	unsigned int ahead = e.due - now;
+	if(ahead == 0 || ahead > 0x80000000u)
+		return;
+	insert(e);
+	++count;
+}
+
+// ONE TICK FORWARD, APPENDS THE EVENTS THAT ARE DUE NOW
+void LifecycleWheel::advance(std::vector<Event>& due)
+{
+	++now;
+
+  // A LOWER LEVEL WRAPPED AROUND -> SPREAD THE NEXT BUCKET ABOVE IT DOWN (HIGHEST FIRST)
+	for(unsigned int l = LEVELS - 1; l > 0; --l)
+	{
+		if((now & ((1u << (BITS * l)) - 1)) != 0)
+			continue;
+
+		cascading.swap(buckets[l][(now >> (BITS * l)) & (BUCKETS - 1)]);
+		for(unsigned int i = 0; i < cascading.size(); ++i)
+			insert(cascading[i]);
+		cascading.clear();
+	}
+
+	std::vector<Event>& bucket = buckets[0][now & (BUCKETS - 1)];
+	due.insert(due.end(), bucket.begin(), bucket.end());
+	count -= bucket.size();
+	bucket.clear();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+// HIERARCHICAL TIMING WHEEL FOR THE LIFECYCLE OF CREATURES
+// 4 levels of 256 buckets, level l holds events that are due within 256^(l+1) ticks.
+// scheduling is O(1), every event moves down at most 3 levels before it fires,
+// so a tick only costs the events that are due (plus a cascade every 256 ticks).
+// events are not cancelled, whoever handles them checks whether they still apply
+class LifecycleWheel
+{
+public:
+	enum Type { READY, DYING, DEAD };
+
+	struct Event
+	{
+		unsigned int slot;
+		unsigned int generation;
+		unsigned int due;
+		unsigned char type;
+	};
+
+	static const unsigned int LEVELS = 4;
+	static const unsigned int BITS = 8;
+	static const unsigned int BUCKETS = 1 << BITS;
+
+private:
+	std::vector<Event> buckets[LEVELS][BUCKETS];
+	std::vector<Event> cascading;
+	unsigned int now;
+	unsigned int count;
+
+	void insert(const Event&);
+
+public:
+  // constructor
+	LifecycleWheel();
+
+  // Methods
+	void clear(unsigned int now = 0);
+	void schedule(const Event&);
+	void advance(std::vector<Event>& due);
+
+  // GETTERS
+	unsigned int getNow() const { return now; }
+	unsigned int getCount() const { return count; }
+};
@@ -0,0 +1,138 @@
+#include "NeighbourLists.h"
+#include "Creature.h"
+#include "SpatialGrid.h"
+#include "CollisionKernel.h"
+
+#include <algorithm>
+
+namespace
+{
+  // A LIST IS REBUILT A LITTLE BEFORE HALF THE SKIN IS USED UP, SO FLOAT ROUNDING IN THE SIGHT TEST CAN'T BITE
+	const float HALF_SKIN = 0.49f;
+}
+
+NeighbourLists::NeighbourLists(unsigned int capacity, float s)
+	: skin(s < 0.f ? 0.f : s), lists(capacity), buildPosition(capacity), buildTravel(capacity, 0.),
+	buildGeneration(capacity, 0), built(capacity, 0), travel(0.)
+{
+}
+
+// EVERY LIST IS STALE
+void NeighbourLists::clear()
+{
+	std::fill(built.begin(), built.end(), 0);
+	newborns.clear();
+	travel = 0.;
+}
+
+void NeighbourLists::setSkin(float s)
+{
+	skin = s < 0.f ? 0.f : s;
+	clear();
+}
+
+// NOBODY MOVED FURTHER THAN THAT DURING THE LAST TICK
+void NeighbourLists::addTravel(float largestStep)
+{
+	travel += largestStep;
+}
+
+// A NEW CREATURE, THE LISTS AROUND IT DON'T KNOW IT YET
+void NeighbourLists::addNewborn(Creature* c)
+{
+	newborns.push_back(c);
+}
+
+// PUT THE NEWBORNS INTO THE LISTS OF EVERYONE WHO MIGHT SEE THEM BEFORE THEIR NEXT REBUILD
+// (serial, before the parallel search)
+// within 2 * skin: the list owner can still move up to a skin, the newborn half of one
+void NeighbourLists::insertNewborns(std::vector<Creature*>& creatures, SpatialGrid& grid)
+{
+  // SO MANY THAT REBUILDING EVERYONE IS CHEAPER
+	if(newborns.size() > creatures.size() / 8)
+	{
+		clear();
+		return;
+	}
+
+	for(unsigned int n = 0; n < newborns.size(); ++n)
+	{
+		Creature* baby = newborns[n];
+		if(!baby->isAlive())
+			continue;
+
+		const sf::Vector2f& p = baby->getPosition();
+		float reach = baby->getRadius() + 2.f * skin;
+
+		unsigned int cells[9];
+		unsigned int cellCount = grid.getNeighbourCells(p, cells);
+		for(unsigned int c = 0; c < cellCount; ++c)
+		{
+			for(unsigned int i = grid.getCellBegin(cells[c]); i < grid.getCellEnd(cells[c]); ++i)
+			{
+				Creature* owner = grid.getEntry(i);
+				unsigned int slot = owner->getSlot();
+				if(owner == baby || !built[slot])
+					continue;
+
+				float dx = grid.getEntryX()[i] - p.x;
+				float dy = grid.getEntryY()[i] - p.y;
+				float r = owner->getSightRadius() + reach;
+				if(dx * dx + dy * dy < r * r)
+					lists[slot].push_back(baby->getHandle());
+			}
+		}
+	}
+	newborns.clear();
+}
+
+// CAN I STILL TRUST MY LIST?
+bool NeighbourLists::isValid(Creature* c)
+{
+	unsigned int slot = c->getSlot();
+	if(!built[slot] || buildGeneration[slot] != c->getHandle().generation)
+		return false;
+
+	float half = HALF_SKIN * skin;
+	sf::Vector2f moved = c->getPosition() - buildPosition[slot];
+	return moved.x * moved.x + moved.y * moved.y <= half * half
+		&& travel - buildTravel[slot] <= half;
+}
+
+// EVERYONE WITHIN sightRadius + size + skin (IN NO PARTICULAR ORDER, THE POPULATION GETS REARRANGED ANYWAY)
+// only writes to the list of that creature, so all creatures can rebuild at once
+void NeighbourLists::rebuild(Creature* c, SpatialGrid& grid)
+{
+	unsigned int slot = c->getSlot();
+	std::vector<CreatureHandle>& list = lists[slot];
+	list.clear();
+
+	const sf::Vector2f& p = c->getPosition();
+	float reach = c->getSightRadius() + skin;
+
+	unsigned int cells[9];
+	unsigned int cellCount = grid.getNeighbourCells(p, cells);
+	for(unsigned int n = 0; n < cellCount; ++n)
+	{
+		unsigned int end = grid.getCellEnd(cells[n]);
+		for(unsigned int begin = grid.getCellBegin(cells[n]); begin < end; begin += CollisionKernel::COLLISION_BATCH)
+		{
+			unsigned int count = std::min(end - begin, CollisionKernel::COLLISION_BATCH);
+			unsigned int hits = CollisionKernel::collidesBatch(p.x, p.y, reach,
+				grid.getEntryX() + begin, grid.getEntryY() + begin, grid.getEntryRadius() + begin, count);
+
+			while(hits != 0)
+			{
+				unsigned int i = begin + CollisionKernel::lowestBit(hits);
+				hits &= hits - 1;
+				if(grid.getEntry(i) != c)
+					list.push_back(grid.getEntry(i)->getHandle());
+			}
+		}
+	}
+
+	buildPosition[slot] = p;
+	buildTravel[slot] = travel;
+	buildGeneration[slot] = c->getHandle().generation;
+	built[slot] = 1;
+}
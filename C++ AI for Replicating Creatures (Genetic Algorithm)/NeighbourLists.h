@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+#include "CreatureHandle.h"
+
+class Creature;
+class SpatialGrid;
+
+// VERLET LISTS FOR THE PARTNER SEARCH
+// every creature caches who was within sightRadius + size + skin when its list was built
+// (in no particular order). the list still holds everyone that can be in sight as long as
+//   - I moved less than half the skin since the build, and
+//   - nobody else did (bounded by adding up the largest step of every tick)
+// otherwise it's rebuilt from the grid. newborns are added to the lists around them,
+// the dead are skipped through their handles and dropped at the next rebuild
+class NeighbourLists
+{
+private:
+	float skin;
+
+	std::vector<std::vector<CreatureHandle> > lists;
+	std::vector<sf::Vector2f> buildPosition;
+	std::vector<double> buildTravel;
+	std::vector<unsigned int> buildGeneration;
+	std::vector<unsigned char> built;
+
+  // sum of the largest step of every tick: nobody moved further than that since a build
+	double travel;
+
+	std::vector<Creature*> newborns;
+
+public:
+  // constructor
+	NeighbourLists(unsigned int capacity, float skin = 20.f);
+
+  // Methods
+	void clear();
+	void setSkin(float);
+	void addTravel(float largestStep);
+	void addNewborn(Creature*);
+	void insertNewborns(std::vector<Creature*>& creatures, SpatialGrid&);
+
+	bool isValid(Creature*);
+	void rebuild(Creature*, SpatialGrid&);
+
+  // GETTERS
+	float getSkin() const { return skin; }
+	float getGridMargin() const { return 2.f * skin; }
+	const std::vector<CreatureHandle>& getList(unsigned int slot) const { return lists[slot]; }
+};
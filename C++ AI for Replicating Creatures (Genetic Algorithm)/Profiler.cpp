@@ -0,0 +1,227 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+std::atomic<bool> Profiler::enabled(false);
+std::mutex Profiler::mutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer> > Profiler::buffers;
+std::vector<Profiler::TickSample> Profiler::ticks;
+std::chrono::steady_clock::time_point Profiler::start = std::chrono::steady_clock::now();
+std::vector<Profiler::Second> Profiler::seconds;
+std::vector<std::string> Profiler::names;
+std::map<const char*, unsigned int> Profiler::nameIndex;
+
+namespace
+{
+	const long long SECOND = 1000000000ll;
+}
+
+const char* Profiler::getCounterName(Counter c)
+{
+	switch(c)
+	{
+	case COLLIDES: return "collides";
+	case AABB_REJECTS: return "aabb rejects";
+	case SQRT_TESTS: return "sqrt tests";
+	case BATCH_TESTS: return "batch tests";
+	case PARTNER_HITS: return "partner hits";
+	case BIRTHS: return "births";
+	case DEATHS: return "deaths";
+	default: return "?";
+	}
+}
+
+// FIRST RECORD OF A THREAD: GIVE IT A BUFFER (KEPT UNTIL THE PROGRAM ENDS)
+Profiler::ThreadBuffer* Profiler::registerThread()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	ThreadBuffer* buffer = new ThreadBuffer();
+	buffer->thread = buffers.size();
+	memset(buffer->counters, 0, sizeof(buffer->counters));
+	buffer->summarized = 0;
+	buffer->dropped = 0;
+	buffers.push_back(std::unique_ptr<ThreadBuffer>(buffer));
+	return buffer;
+}
+
+void Profiler::setEnabled(bool e)
+{
+	enabled = e;
+}
+
+// FORGET EVERYTHING RECORDED SO FAR
+// (only while no thread is recording, e.g. between ticks)
+void Profiler::reset()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for(unsigned int i = 0; i < buffers.size(); ++i)
+	{
+		buffers[i]->events.clear();
+		memset(buffers[i]->counters, 0, sizeof(buffers[i]->counters));
+		buffers[i]->summarized = 0;
+		buffers[i]->dropped = 0;
+	}
+	ticks.clear();
+	seconds.clear();
+	start = std::chrono::steady_clock::now();
+}
+
+// THE SUMMARY ENTRY OF THE SECOND time FALLS INTO (THE ONES BEFORE IT ARE ADDED IF NEEDED)
+Profiler::Second& Profiler::getSecond(long long time)
+{
+	unsigned int second = (unsigned int)(std::max(time, 0ll) / SECOND);
+	while(seconds.size() <= second)
+	{
+		Second s;
+		s.ticks = 0;
+		memset(s.counters, 0, sizeof(s.counters));
+		seconds.push_back(s);
+	}
+	return seconds[second];
+}
+
+// SCOPE NAMES ARE STRING LITERALS: LOOKED UP BY POINTER, THE SAME TEXT IN ANOTHER FILE GETS THE SAME INDEX
+unsigned int Profiler::getNameIndex(const char* name)
+{
+	std::map<const char*, unsigned int>::iterator found = nameIndex.find(name);
+	if(found != nameIndex.end())
+		return found->second;
+
+	unsigned int index = std::find(names.begin(), names.end(), std::string(name)) - names.begin();
+	if(index == names.size())
+		names.push_back(name);
+	nameIndex[name] = index;
+	return index;
+}
+
+// ADD THE SCOPES RECORDED SINCE THE LAST CALL TO THE SUMMARY, THEN CUT THE BUFFERS DOWN TO TRACE_LIMIT
+// (lock held, no thread recording)
+void Profiler::summarize()
+{
+	for(unsigned int i = 0; i < buffers.size(); ++i)
+	{
+		ThreadBuffer& buffer = *buffers[i];
+		for(unsigned int e = buffer.summarized; e < buffer.events.size(); ++e)
+		{
+			const Event& event = buffer.events[e];
+			unsigned int name = getNameIndex(event.name);
+			std::vector<double>& milliseconds = getSecond(event.begin).milliseconds;
+			if(milliseconds.size() <= name)
+				milliseconds.resize(name + 1, 0.0);
+			milliseconds[name] += (event.end - event.begin) / 1e6;
+		}
+
+		if(buffer.events.size() > TRACE_LIMIT)
+		{
+			buffer.dropped += buffer.events.size() - TRACE_LIMIT;
+			buffer.events.resize(TRACE_LIMIT);
+		}
+		buffer.summarized = buffer.events.size();
+	}
+}
+
+// SAMPLE THE COUNTERS OF ALL THREADS AND SUMMARIZE THE TICK
+// called between ticks, the workers are idle and the thread pool already synchronized with them
+void Profiler::endTick()
+{
+	if(!isEnabled())
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	TickSample sample;
+	sample.time = now();
+	memset(sample.counters, 0, sizeof(sample.counters));
+	for(unsigned int i = 0; i < buffers.size(); ++i)
+		for(unsigned int c = 0; c < COUNTER_COUNT; ++c)
+			sample.counters[c] += buffers[i]->counters[c];
+	if(ticks.size() < TRACE_LIMIT)
+		ticks.push_back(sample);
+
+	Second& second = getSecond(sample.time);
+	++second.ticks;
+	memcpy(second.counters, sample.counters, sizeof(second.counters));
+	summarize();
+}
+
+// CHROME TRACE (chrome://tracing, perfetto): ONE ROW PER THREAD, COUNTERS PER TICK
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	FILE* f = fopen(path.c_str(), "w");
+	if(f == NULL)
+		return false;
+
+	fprintf(f, "{\"traceEvents\":[\n");
+	bool first = true;
+	for(unsigned int i = 0; i < buffers.size(); ++i)
+	{
+		fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+			first ? "" : ",\n", buffers[i]->thread, buffers[i]->thread);
+		first = false;
+
+		const std::vector<Event>& events = buffers[i]->events;
+		for(unsigned int e = 0; e < events.size(); ++e)
+		{
+			fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				events[e].name, buffers[i]->thread, events[e].begin / 1000.0, (events[e].end - events[e].begin) / 1000.0);
+		}
+	}
+
+  // COUNTERS AS "PER TICK" GRAPHS
+	for(unsigned int t = 0; t < ticks.size(); ++t)
+	{
+		fprintf(f, "%s{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{", first ? "" : ",\n", ticks[t].time / 1000.0);
+		first = false;
+		for(unsigned int c = 0; c < COUNTER_COUNT; ++c)
+		{
+			unsigned long long previous = t > 0 ? ticks[t - 1].counters[c] : 0;
+			fprintf(f, "%s\"%s\":%llu", c > 0 ? "," : "", getCounterName((Counter)c), ticks[t].counters[c] - previous);
+		}
+		fprintf(f, "}}");
+	}
+	fprintf(f, "\n]}\n");
+
+	bool ok = !ferror(f);
+	return fclose(f) == 0 && ok;
+}
+
+// ONE BLOCK PER SECOND: TICKS, MILLISECONDS PER SCOPE (ALL THREADS ADDED UP) AND COUNTERS
+void Profiler::writeSummary(FILE* f)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	summarize();
+
+	const unsigned long long* before = NULL;
+	unsigned long long dropped = 0;
+	for(unsigned int i = 0; i < buffers.size(); ++i)
+		dropped += buffers[i]->dropped;
+
+	for(unsigned int s = 0; s < seconds.size(); ++s)
+	{
+		const Second& second = seconds[s];
+		fprintf(f, "second %u: %u ticks\n", s, second.ticks);
+
+    // BY NAME, LIKE A MAP WOULD LIST THEM
+		std::vector<std::pair<std::string, double> > scopes;
+		for(unsigned int n = 0; n < second.milliseconds.size(); ++n)
+			if(second.milliseconds[n] > 0.0)
+				scopes.push_back(std::make_pair(names[n], second.milliseconds[n]));
+		std::sort(scopes.begin(), scopes.end());
+		for(unsigned int n = 0; n < scopes.size(); ++n)
+			fprintf(f, "  %-24s %10.3f ms\n", scopes[n].first.c_str(), scopes[n].second);
+
+		if(second.ticks > 0)
+		{
+			for(unsigned int c = 0; c < COUNTER_COUNT; ++c)
+				fprintf(f, "  %-24s %10llu\n", getCounterName((Counter)c),
+					second.counters[c] - (before != NULL ? before[c] : 0));
+			before = second.counters;
+		}
+	}
+	if(dropped > 0)
+		fprintf(f, "(the trace only has the first %u scopes of every thread, %llu more are in this summary only)\n",
+			TRACE_LIMIT, dropped);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// WHERE DOES A TICK GO?
+// scopes (PROFILE_SCOPE) and counters (PROFILE_COUNT) are recorded into a buffer per
+// thread, nothing is shared while recording. the pool calls endTick() after every tick,
+// which samples the counters of all threads and adds the new scopes to a summary with one
+// entry per second, so the summary of a run of hours costs no more than its seconds.
+// the trace keeps the first TRACE_LIMIT scopes of every thread and the first TRACE_LIMIT
+// ticks, whatever comes after that is only in the summary.
+//
+// compiled in with CREATURES_PROFILE, otherwise the macros are empty.
+// compiled in but disabled, a scope costs one relaxed load
+class Profiler
+{
+public:
+	enum Counter
+	{
+		COLLIDES,
+		AABB_REJECTS,
+		SQRT_TESTS,
+		BATCH_TESTS,
+		PARTNER_HITS,
+		BIRTHS,
+		DEATHS,
+		COUNTER_COUNT
+	};
+
+	static const unsigned int TRACE_LIMIT = 1 << 20;
+
+	struct Event
+	{
+		const char* name;
+		long long begin;
+		long long end;
+	};
+
+	struct TickSample
+	{
+		long long time;
+		unsigned long long counters[COUNTER_COUNT];
+	};
+
+  // everything one thread recorded (only that thread writes to it)
+	struct ThreadBuffer
+	{
+		unsigned int thread;
+		std::vector<Event> events;
+		unsigned long long counters[COUNTER_COUNT];
+
+    // events before this one are in the summary already, and how many didn't fit into the trace
+		unsigned int summarized;
+		unsigned long long dropped;
+	};
+
+private:
+  // one second of the summary: ticks that ended in it, the counters after the last of
+  // them, milliseconds per scope (indexed like names, all threads added up)
+	struct Second
+	{
+		unsigned int ticks;
+		unsigned long long counters[COUNTER_COUNT];
+		std::vector<double> milliseconds;
+	};
+
+	static std::atomic<bool> enabled;
+	static std::mutex mutex;
+	static std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+	static std::vector<TickSample> ticks;
+	static std::chrono::steady_clock::time_point start;
+
+	static std::vector<Second> seconds;
+	static std::vector<std::string> names;
+	static std::map<const char*, unsigned int> nameIndex;
+
+	static ThreadBuffer* registerThread();
+	static Second& getSecond(long long time);
+	static unsigned int getNameIndex(const char*);
+	static void summarize();
+
+public:
+  // Methods
+	static void setEnabled(bool);
+	static void reset();
+	static void endTick();
+
+	static bool writeChromeTrace(const std::string& path);
+	static void writeSummary(FILE*);
+
+  // recording (only called through the macros)
+	static ThreadBuffer& getBuffer()
+	{
+		static thread_local ThreadBuffer* buffer = NULL;
+		if(buffer == NULL)
+			buffer = registerThread();
+		return *buffer;
+	}
+	static long long now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	static void count(Counter c, unsigned long long n)
+	{
+		if(isEnabled())
+			getBuffer().counters[c] += n;
+	}
+
+  // GETTERS
+	static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+	static const char* getCounterName(Counter);
+};
+
+// TIMES THE BLOCK IT LIVES IN
+class ProfileScope
+{
+private:
+	const char* name;
+	long long begin;
+
+public:
+	ProfileScope(const char* n)
+		: name(Profiler::isEnabled() ? n : NULL), begin(name != NULL ? Profiler::now() : 0)
+	{
+	}
+	~ProfileScope()
+	{
+		if(name == NULL)
+			return;
+		Profiler::Event e = { name, begin, Profiler::now() };
+		Profiler::getBuffer().events.push_back(e);
+	}
+};
+
+#ifdef CREATURES_PROFILE
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_JOIN(profileScope, __LINE__)(name)
+#define PROFILE_COUNT(counter, n) Profiler::count(Profiler::counter, n)
+#define PROFILE_TICK() Profiler::endTick()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_TICK() ((void)0)
+#endif
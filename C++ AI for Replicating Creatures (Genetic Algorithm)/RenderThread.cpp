@@ -0,0 +1,65 @@
+#include "RenderThread.h"
+
+#ifndef CREATURES_HEADLESS
+
+#include <chrono>
+
+RenderThread::RenderThread(sf::RenderWindow& w, FrameExchange& f, unsigned int segments)
+	: window(&w), frames(&f), renderer(segments), running(false), drawn(0)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	stop();
+}
+
+// (BEFORE start)
+void RenderThread::setBackground(const sf::Color& c)
+{
+	background = c;
+}
+
+// THE WINDOW'S GL CONTEXT MOVES TO THE RENDER THREAD
+void RenderThread::start()
+{
+	if(running.load())
+		return;
+
+	window->setActive(false);
+	running.store(true);
+	thread = std::thread(&RenderThread::run, this);
+}
+
+// ... AND BACK TO THE CALLING THREAD
+void RenderThread::stop()
+{
+	if(!running.load())
+		return;
+
+	running.store(false);
+	thread.join();
+	window->setActive(true);
+}
+
+void RenderThread::run()
+{
+	window->setActive(true);
+	while(running.load())
+	{
+    // NOTHING NEW: DON'T DRAW THE SAME FRAME AGAIN
+		if(!frames->acquire() && drawn.load() > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		window->clear(background);
+		renderer.draw(*window, frames->getFront());
+		window->display();
+		++drawn;
+	}
+	window->setActive(false);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifndef CREATURES_HEADLESS
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <thread>
+
+#include "CreatureRenderer.h"
+#include "FrameExchange.h"
+
+// DRAWS THE LATEST PUBLISHED FRAME ON ITS OWN THREAD
+// the simulation keeps ticking while a frame is drawn (and while display() waits for vsync),
+// a slow tick only means the same frame stays on screen a little longer.
+// the window belongs to the render thread while it runs: events are still polled on the
+// thread that created the window, everything that draws or displays happens here
+class RenderThread
+{
+private:
+	sf::RenderWindow* window;
+	FrameExchange* frames;
+	CreatureRenderer renderer;
+	sf::Color background;
+
+	std::thread thread;
+	std::atomic<bool> running;
+	std::atomic<unsigned long long> drawn;
+
+	void run();
+
+public:
+  // constructor
+	RenderThread(sf::RenderWindow&, FrameExchange&, unsigned int segments = 16);
+	~RenderThread();
+
+  // Methods
+	void setBackground(const sf::Color&);
+	void start();
+	void stop();
+
+  // GETTERS
+	bool isRunning() const { return running.load(); }
+	unsigned long long getFrameCount() const { return drawn.load(); }
+
+private:
+	RenderThread(const RenderThread&);
+	RenderThread& operator=(const RenderThread&);
+};
+
+#endif
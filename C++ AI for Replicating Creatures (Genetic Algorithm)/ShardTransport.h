@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+// HOW THE SHARDS OF A WORLD TALK TO EACH OTHER (SEE WorldShard)
+// once per tick every shard sends one message to each of its peers and receives one
+// from each of them. exchange() only returns when all of them arrived, so the shards
+// move in lock step. a backend has to deliver the messages of a peer in order, and
+// may never wait for its own sends to be read before it reads (everyone sends at once)
+class ShardTransport
+{
+public:
+	virtual ~ShardTransport() {}
+
+  // Methods
+	virtual void exchange(const std::vector<unsigned int>& peers,
+		const std::vector<std::vector<char> >& outgoing, std::vector<std::vector<char> >& incoming) = 0;
+};
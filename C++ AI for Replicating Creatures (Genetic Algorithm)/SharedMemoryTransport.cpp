@@ -0,0 +1,179 @@
+#include "SharedMemoryTransport.h"
+
+// POSIX ONLY, OTHER PLATFORMS BUILD WITHOUT IT
+#ifndef _WIN32
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// RING HEADER, THE BYTES FOLLOW RIGHT BEHIND IT
+// head and tail count every byte ever written / read, so they never wrap in practice
+struct SharedMemoryTransport::Ring
+{
+	std::atomic<unsigned long long> head;
+	char padding0[64 - sizeof(std::atomic<unsigned long long>)];
+	std::atomic<unsigned long long> tail;
+	char padding1[64 - sizeof(std::atomic<unsigned long long>)];
+
+	char* getBytes() { return (char*)(this + 1); }
+};
+
+namespace
+{
+	const unsigned int LENGTH_SIZE = 4;
+
+  // AS MUCH AS FITS, RETURNS HOW MUCH THAT WAS
+	unsigned long long pushBytes(std::atomic<unsigned long long>& head, std::atomic<unsigned long long>& tail,
+		char* ring, unsigned long long capacity, const char* bytes, unsigned long long count)
+	{
+		unsigned long long h = head.load(std::memory_order_relaxed);
+		unsigned long long free = capacity - (h - tail.load(std::memory_order_acquire));
+		count = std::min(count, free);
+
+		unsigned long long at = h % capacity;
+		unsigned long long first = std::min(count, capacity - at);
+		memcpy(ring + at, bytes, first);
+		memcpy(ring, bytes + first, count - first);
+
+		head.store(h + count, std::memory_order_release);
+		return count;
+	}
+
+  // AS MUCH AS IS THERE (UP TO count), RETURNS HOW MUCH THAT WAS
+	unsigned long long popBytes(std::atomic<unsigned long long>& head, std::atomic<unsigned long long>& tail,
+		const char* ring, unsigned long long capacity, char* bytes, unsigned long long count)
+	{
+		unsigned long long t = tail.load(std::memory_order_relaxed);
+		count = std::min(count, head.load(std::memory_order_acquire) - t);
+
+		unsigned long long at = t % capacity;
+		unsigned long long first = std::min(count, capacity - at);
+		memcpy(bytes, ring + at, first);
+		memcpy(bytes + first, ring, count - first);
+
+		tail.store(t + count, std::memory_order_release);
+		return count;
+	}
+
+  // NOTHING MOVED: SPIN A LITTLE, THEN GIVE THE CORE TO THE OTHER SHARDS
+	void backOff(unsigned int idle)
+	{
+		if(idle < 64)
+			std::this_thread::yield();
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+}
+
+SharedMemoryTransport::SharedMemoryTransport(const std::string& n, unsigned int count, unsigned int s, unsigned int capacity)
+	: name(n), shardCount(count), shard(s), ringCapacity((capacity + 63) / 64 * 64), memory(NULL), size(0)
+{
+	size = (unsigned long long)shardCount * shardCount * (sizeof(Ring) + ringCapacity);
+
+  // A FRESH SEGMENT IS ALL ZEROES: EVERY RING IS EMPTY
+	int file = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+	if(file < 0)
+		return;
+	if(ftruncate(file, size) == 0)
+	{
+		void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		if(mapped != MAP_FAILED)
+			memory = (char*)mapped;
+	}
+	close(file);
+}
+
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+	if(memory != NULL)
+		munmap(memory, size);
+}
+
+// REMOVE THE SEGMENT (MAPPINGS STAY VALID UNTIL THEY'RE CLOSED), CALL BEFORE A RUN SO NO OLD RINGS ARE LEFT
+void SharedMemoryTransport::unlink(const std::string& name)
+{
+	shm_unlink(name.c_str());
+}
+
+SharedMemoryTransport::Ring* SharedMemoryTransport::getRing(unsigned int from, unsigned int to)
+{
+	return (Ring*)(memory + (unsigned long long)(from * shardCount + to) * (sizeof(Ring) + ringCapacity));
+}
+
+// WRITE TO ALL PEERS AND READ FROM ALL PEERS AT THE SAME TIME, SO A FULL RING NEVER DEADLOCKS
+void SharedMemoryTransport::exchange(const std::vector<unsigned int>& peers,
+	const std::vector<std::vector<char> >& outgoing, std::vector<std::vector<char> >& incoming)
+{
+	std::vector<unsigned long long> sent(peers.size(), 0);
+	std::vector<unsigned long long> received(peers.size(), 0);
+	std::vector<unsigned int> lengths(peers.size(), 0);
+	incoming.resize(peers.size());
+
+	unsigned int idle = 0;
+	for(;;)
+	{
+		bool done = true;
+		bool moved = false;
+		for(unsigned int p = 0; p < peers.size(); ++p)
+		{
+      // SEND: LENGTH, THEN THE MESSAGE
+			Ring* out = getRing(shard, peers[p]);
+			unsigned long long total = LENGTH_SIZE + outgoing[p].size();
+			while(sent[p] < total)
+			{
+				unsigned long long n;
+				if(sent[p] < LENGTH_SIZE)
+				{
+					unsigned int length = outgoing[p].size();
+					n = pushBytes(out->head, out->tail, out->getBytes(), ringCapacity,
+						(const char*)&length + sent[p], LENGTH_SIZE - sent[p]);
+				}
+				else
+					n = pushBytes(out->head, out->tail, out->getBytes(), ringCapacity,
+						&outgoing[p][0] + (sent[p] - LENGTH_SIZE), total - sent[p]);
+				if(n == 0)
+					break;
+				sent[p] += n;
+				moved = true;
+			}
+
+      // RECEIVE THE SAME WAY
+			Ring* in = getRing(peers[p], shard);
+			while(received[p] < LENGTH_SIZE || received[p] < LENGTH_SIZE + lengths[p])
+			{
+				unsigned long long n;
+				if(received[p] < LENGTH_SIZE)
+				{
+					n = popBytes(in->head, in->tail, in->getBytes(), ringCapacity,
+						(char*)&lengths[p] + received[p], LENGTH_SIZE - received[p]);
+					if(received[p] + n == LENGTH_SIZE)
+						incoming[p].resize(lengths[p]);
+				}
+				else
+					n = popBytes(in->head, in->tail, in->getBytes(), ringCapacity,
+						&incoming[p][0] + (received[p] - LENGTH_SIZE), LENGTH_SIZE + lengths[p] - received[p]);
+				if(n == 0)
+					break;
+				received[p] += n;
+				moved = true;
+			}
+
+			done = done && sent[p] == total && received[p] >= LENGTH_SIZE && received[p] == LENGTH_SIZE + lengths[p];
+		}
+
+		if(done)
+			return;
+		idle = moved ? 0 : idle + 1;
+		if(!moved)
+			backOff(idle);
+	}
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ShardTransport.h"
+
+// SHARDS AS PROCESSES ON ONE MACHINE, TALKING THROUGH A POSIX SHARED MEMORY SEGMENT
+// the segment holds one single producer / single consumer byte ring for every ordered
+// pair of shards (from * shardCount + to). messages are [length][bytes], a message
+// bigger than the ring streams through it. only the pages of rings that are actually
+// used get backed by memory. POSIX only (shm_open / mmap)
+class SharedMemoryTransport : public ShardTransport
+{
+private:
+	struct Ring;
+
+	std::string name;
+	unsigned int shardCount;
+	unsigned int shard;
+	unsigned int ringCapacity;
+
+	char* memory;
+	unsigned long long size;
+
+	Ring* getRing(unsigned int from, unsigned int to);
+
+public:
+  // constructor (opens the segment, creates it if this is the first shard to get there)
+	SharedMemoryTransport(const std::string& name, unsigned int shardCount, unsigned int shard, unsigned int ringCapacity = 1 << 22);
+	~SharedMemoryTransport();
+
+  // Methods
+	virtual void exchange(const std::vector<unsigned int>& peers,
+		const std::vector<std::vector<char> >& outgoing, std::vector<std::vector<char> >& incoming);
+
+	static void unlink(const std::string& name);
+
+  // GETTERS
+	bool isOpen() const { return memory != NULL; }
+	unsigned int getShard() const { return shard; }
+
+private:
+	SharedMemoryTransport(const SharedMemoryTransport&);
+	SharedMemoryTransport& operator=(const SharedMemoryTransport&);
+};
@@ -0,0 +1,343 @@
+#include "Snapshot.h"
+#include "CreaturePool.h"
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace
+{
+	const unsigned int HEADER_FIELDS = 40;
+	const unsigned int HEADER_SIZE = (HEADER_FIELDS + 8 * Snapshot::SECTION_COUNT + Snapshot::ALIGNMENT - 1)
+		/ Snapshot::ALIGNMENT * Snapshot::ALIGNMENT;
+
+  // BYTE BY BYTE, SO IT'S LITTLE ENDIAN ON EVERY HOST (COMPILES TO A PLAIN MOVE ON X86)
+	void put32(char* p, unsigned int v)
+	{
+		p[0] = (char)v; p[1] = (char)(v >> 8); p[2] = (char)(v >> 16); p[3] = (char)(v >> 24);
+	}
+	void put64(char* p, unsigned long long v)
+	{
+		put32(p, (unsigned int)v);
+		put32(p + 4, (unsigned int)(v >> 32));
+	}
+	void putFloat(char* p, float f)
+	{
+		unsigned int v;
+		memcpy(&v, &f, 4);
+		put32(p, v);
+	}
+
+	unsigned int get32(const char* p)
+	{
+		const unsigned char* b = (const unsigned char*)p;
+		return b[0] | (b[1] << 8) | (b[2] << 16) | ((unsigned int)b[3] << 24);
+	}
+	unsigned long long get64(const char* p)
+	{
+		return get32(p) | ((unsigned long long)get32(p + 4) << 32);
+	}
+	float getFloat(const char* p)
+	{
+		unsigned int v = get32(p);
+		float f;
+		memcpy(&f, &v, 4);
+		return f;
+	}
+
+	unsigned long long align(unsigned long long size)
+	{
+		return (size + Snapshot::ALIGNMENT - 1) / Snapshot::ALIGNMENT * Snapshot::ALIGNMENT;
+	}
+}
+
+unsigned int Snapshot::getElementSize(Section s)
+{
+	switch(s)
+	{
+	case POSITION:
+	case TARGET:
+		return 8;
+	case STATE:
+		return 1;
+	default:
+		return 4;
+	}
+}
+
+// COPY THE POOL INTO A FILE IMAGE
+void Snapshot::capture(CreaturePool& pool, std::vector<char>& image)
+{
+	CreatureData& data = pool.data;
+	std::vector<Creature*>& creatures = pool.creatures;
+	unsigned int count = creatures.size();
+
+  // LAYOUT
+	unsigned long long offsets[SECTION_COUNT];
+	unsigned long long size = HEADER_SIZE;
+	for(unsigned int s = 0; s < SECTION_COUNT; ++s)
+	{
+		offsets[s] = size;
+		size += align((unsigned long long)count * getElementSize((Section)s));
+	}
+	image.assign(size, 0);
+	char* out = &image[0];
+
+  // HEADER
+	memcpy(out, "CRTR", 4);
+	put32(out + 4, VERSION);
+	put32(out + 8, count);
+	put32(out + 12, Creature::ID);
+	put32(out + 16, pool.windowSize->x);
+	put32(out + 20, pool.windowSize->y);
+	put64(out + 24, data.seed);
+	put64(out + 32, pool.tickCount);
+	for(unsigned int s = 0; s < SECTION_COUNT; ++s)
+		put64(out + HEADER_FIELDS + 8 * s, offsets[s]);
+
+  // SECTIONS
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int slot = creatures[i]->getSlot();
+		Creature* partner = creatures[i]->getPartner();
+
+		put32(out + offsets[ID] + 4 * i, data.id[slot]);
+		putFloat(out + offsets[POSITION] + 8 * i, data.position[slot].x);
+		putFloat(out + offsets[POSITION] + 8 * i + 4, data.position[slot].y);
+		putFloat(out + offsets[BODY_RADIUS] + 4 * i, creatures[i]->getBodyRadius());
+		put32(out + offsets[LIFE_TIME] + 4 * i, creatures[i]->getLifeTime());
+		out[offsets[STATE] + i] = (char)data.state[slot];
+		put32(out + offsets[RANDOM_DRAWS] + 4 * i, data.randomDraws[slot]);
+		put32(out + offsets[PARTNER] + 4 * i, (partner != NULL) ? partner->getId() : -1);
+		putFloat(out + offsets[TARGET] + 8 * i, data.target[slot].x);
+		putFloat(out + offsets[TARGET] + 8 * i + 4, data.target[slot].y);
+
+		unsigned int genes[Genome::Genes::COUNT];
+		Genome::Genes::save(data.genes, slot, genes);
+		for(unsigned int g = 0; g < Genome::Genes::COUNT; ++g)
+			put32(out + offsets[GENES + g] + 4 * i, genes[g]);
+	}
+}
+
+// REPLACE THE POOL WITH A FILE IMAGE
+// returns false (and leaves the pool alone) if the image is broken or doesn't fit: too many
+// creatures for the pool, or another window size (positions and targets would be off)
+bool Snapshot::restore(CreaturePool& pool, const std::vector<char>& image)
+{
+	if(image.size() < HEADER_SIZE || memcmp(&image[0], "CRTR", 4) != 0)
+		return false;
+
+	const char* in = &image[0];
+	if(get32(in + 4) != VERSION)
+		return false;
+
+	unsigned int count = get32(in + 8);
+	if(count > pool.capacity)
+		return false;
+	if(get32(in + 16) != pool.windowSize->x || get32(in + 20) != pool.windowSize->y)
+		return false;
+
+	unsigned long long offsets[SECTION_COUNT];
+	for(unsigned int s = 0; s < SECTION_COUNT; ++s)
+	{
+		offsets[s] = get64(in + HEADER_FIELDS + 8 * s);
+		if(offsets[s] + (unsigned long long)count * getElementSize((Section)s) > image.size())
+			return false;
+	}
+
+	CreatureData& data = pool.data;
+	pool.clear();
+	pool.tickCount = get64(in + 32);
+	data.lifecycle.clear((unsigned int)pool.tickCount);
+	data.seed = get64(in + 24);
+	Creature::ID = get32(in + 12);
+
+  // CREATURES (THE FREE LIST HANDS OUT SLOTS 0, 1, 2, ...)
+	std::unordered_map<int, Creature*> byId;
+	byId.reserve(count);
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		Creature* c = pool.allocate();
+		unsigned int slot = c->getSlot();
+
+		data.id[slot] = get32(in + offsets[ID] + 4 * i);
+		data.position[slot] = sf::Vector2f(getFloat(in + offsets[POSITION] + 8 * i), getFloat(in + offsets[POSITION] + 8 * i + 4));
+		data.birth[slot] = data.lifecycle.getNow() - get32(in + offsets[LIFE_TIME] + 4 * i);
+		data.state[slot] = (unsigned char)in[offsets[STATE] + i];
+		data.randomDraws[slot] = get32(in + offsets[RANDOM_DRAWS] + 4 * i);
+
+		unsigned int genes[Genome::Genes::COUNT];
+		for(unsigned int g = 0; g < Genome::Genes::COUNT; ++g)
+			genes[g] = get32(in + offsets[GENES + g] + 4 * i);
+		Genome::Genes::load(data.genes, slot, genes);
+		c->setPartner(NULL);
+		c->setTargetPosition(sf::Vector2f(getFloat(in + offsets[TARGET] + 8 * i), getFloat(in + offsets[TARGET] + 8 * i + 4)));
+		pool.settle(c);
+
+		byId[data.id[slot]] = c;
+	}
+
+  // PARTNER IDS -> HANDLES
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		int partner = get32(in + offsets[PARTNER] + 4 * i);
+		std::unordered_map<int, Creature*>::iterator found = byId.find(partner);
+		if(partner >= 0 && found != byId.end())
+			pool.creatures[i]->setPartner(found->second);
+	}
+	return true;
+}
+
+bool Snapshot::writeFile(const std::string& path, const std::vector<char>& image)
+{
+  // WRITE NEXT TO IT FIRST, SO A CRASH NEVER LEAVES HALF A SNAPSHOT BEHIND
+  // (the old file is replaced in one step, there's always a whole snapshot on disk. windows'
+  // rename doesn't replace an existing file, MoveFileEx does)
+	std::string temporary = path + ".tmp";
+	FILE* file = fopen(temporary.c_str(), "wb");
+	if(file == NULL)
+		return false;
+	bool ok = fwrite(&image[0], 1, image.size(), file) == image.size();
+	ok = (fclose(file) == 0) && ok;
+	if(!ok)
+		return false;
+
+#ifdef _WIN32
+	return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
+
+bool Snapshot::readFile(const std::string& path, std::vector<char>& image)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if(file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	bool ok = size > 0;
+	if(ok)
+	{
+		image.resize(size);
+		ok = fread(&image[0], 1, size, file) == (size_t)size;
+	}
+	fclose(file);
+	return ok;
+}
+
+bool Snapshot::save(CreaturePool& pool, const std::string& path)
+{
+	std::vector<char> image;
+	capture(pool, image);
+	return writeFile(path, image);
+}
+
+bool Snapshot::load(CreaturePool& pool, const std::string& path)
+{
+	std::vector<char> image;
+	return readFile(path, image) && restore(pool, image);
+}
+
+
+SnapshotWriter::SnapshotWriter()
+	: stopping(false), failures(0), dropped(0)
+{
+	states[0] = FREE;
+	states[1] = FREE;
+	thread = std::thread(&SnapshotWriter::work, this);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+	flush();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+}
+
+// CAPTURE NOW, WRITE LATER (NEVER WAITS FOR THE DISK)
+bool SnapshotWriter::save(CreaturePool& pool, const std::string& path)
+{
+	int buffer = -1;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+    // A WAITING ONE IS REPLACED, SO AT MOST ONE IS WAITING AND THEY HIT THE DISK IN ORDER
+		for(unsigned int b = 0; b < 2 && buffer < 0; ++b)
+			if(states[b] == QUEUED) buffer = b;
+		if(buffer >= 0)
+			++dropped;
+		for(unsigned int b = 0; b < 2 && buffer < 0; ++b)
+			if(states[b] == FREE) buffer = b;
+		if(buffer < 0)
+			return false;
+		states[buffer] = CAPTURING;
+	}
+
+	Snapshot::capture(pool, buffers[buffer]);
+	paths[buffer] = path;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		states[buffer] = QUEUED;
+	}
+	wake.notify_one();
+	return true;
+}
+
+// WAIT UNTIL EVERYTHING IS ON DISK
+void SnapshotWriter::flush()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while(states[0] == QUEUED || states[1] == QUEUED || states[0] == WRITING || states[1] == WRITING)
+		idle.wait(lock);
+}
+
+unsigned int SnapshotWriter::getFailures()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return failures;
+}
+
+unsigned int SnapshotWriter::getDropped()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return dropped;
+}
+
+// BACKGROUND THREAD
+void SnapshotWriter::work()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for(;;)
+	{
+		int buffer = (states[0] == QUEUED) ? 0 : (states[1] == QUEUED) ? 1 : -1;
+		if(buffer < 0)
+		{
+			if(stopping)
+				return;
+			wake.wait(lock);
+			continue;
+		}
+
+		states[buffer] = WRITING;
+		lock.unlock();
+		bool ok = Snapshot::writeFile(paths[buffer], buffers[buffer]);
+		lock.lock();
+
+		if(!ok) ++failures;
+		states[buffer] = FREE;
+		idle.notify_all();
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Genome.h"
+
+class CreaturePool;
+
+// BINARY CHECKPOINT OF A WHOLE POOL
+//
+// little endian, version 2:
+//   header    magic "CRTR", version, count, next id, window size, seed, tick,
+//             then one 64 bit file offset per section
+//   sections  one array per field with an entry per creature (population order),
+//             every section starts 64 byte aligned, so a mapped file can be used as is
+// partners are stored as ids (-1 = none), MoveAction as its target position.
+// the body radius is only there for readers, a loaded pool derives it from the age.
+// the genes come last, a section per gene of Genome::Genes in its order (GENES + index),
+// each entry the gene's 32 bit word (Genome::toWord)
+class Snapshot
+{
+public:
+	enum Section
+	{
+		ID,
+		POSITION,
+		BODY_RADIUS,
+		LIFE_TIME,
+		STATE,
+		RANDOM_DRAWS,
+		PARTNER,
+		TARGET,
+		GENES,
+		SECTION_COUNT = GENES + Genome::Genes::COUNT
+	};
+
+	static const unsigned int VERSION = 2;
+	static const unsigned int ALIGNMENT = 64;
+
+  // Methods
+	static void capture(CreaturePool&, std::vector<char>& image);
+	static bool restore(CreaturePool&, const std::vector<char>& image);
+
+	static bool save(CreaturePool&, const std::string& path);
+	static bool load(CreaturePool&, const std::string& path);
+
+	static bool writeFile(const std::string& path, const std::vector<char>& image);
+	static bool readFile(const std::string& path, std::vector<char>& image);
+
+	static unsigned int getElementSize(Section);
+};
+
+// WRITES SNAPSHOTS ON A BACKGROUND THREAD
+// save() only copies the pool into a free buffer, the file is written later.
+// there are two buffers: one can be on its way to disk while the next is captured.
+// if a capture is still waiting when the next one comes in, the newer one replaces it
+// (counted in getDropped)
+class SnapshotWriter
+{
+private:
+	enum BufferState { FREE, CAPTURING, QUEUED, WRITING };
+
+	std::vector<char> buffers[2];
+	std::string paths[2];
+	BufferState states[2];
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	bool stopping;
+	unsigned int failures;
+	unsigned int dropped;
+
+	std::thread thread;
+
+	void work();
+
+public:
+  // constructor
+	SnapshotWriter();
+	~SnapshotWriter();
+
+  // Methods
+	bool save(CreaturePool&, const std::string& path);
+	void flush();
+
+  // GETTERS
+	unsigned int getFailures();
+	unsigned int getDropped();
+
+private:
+	SnapshotWriter(const SnapshotWriter&);
+	SnapshotWriter& operator=(const SnapshotWriter&);
+};
@@ -0,0 +1,109 @@
+#include "SpatialGrid.h"
+#include "Creature.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(sf::Vector2u& w)
+	: windowSize(&w), cellWidth(1.f), cellHeight(1.f), columns(1), rows(1)
+{
+	cellStart.assign(2, 0);
+}
+
+// WRAP A CELL COORDINATE AROUND THE TORUS
+unsigned int SpatialGrid::wrap(int cell, unsigned int count) const
+{
+	int c = cell % (int)count;
+	return (c < 0) ? c + count : c;
+}
+
+// CELL THAT CONTAINS A POSITION (POSITIONS SLIGHTLY OFF SCREEN WRAP AROUND)
+unsigned int SpatialGrid::cellOf(const sf::Vector2f& p) const
+{
+	unsigned int x = wrap((int)floorf(p.x / cellWidth), columns);
+	unsigned int y = wrap((int)floorf(p.y / cellHeight), rows);
+	return y * columns + x;
+}
+
+// THE (UP TO) 9 DISTINCT CELLS AROUND A POSITION
+unsigned int SpatialGrid::getNeighbourCells(const sf::Vector2f& p, unsigned int cells[9]) const
+{
+	int cx = (int)floorf(p.x / cellWidth);
+	int cy = (int)floorf(p.y / cellHeight);
+
+  // A GRID WITH LESS THAN 3 CELLS PER AXIS WOULD VISIT CELLS TWICE
+	int dxMin = (columns < 3) ? -cx : -1;
+	int dxMax = (columns < 3) ? (int)columns - 1 - cx : 1;
+	int dyMin = (rows < 3) ? -cy : -1;
+	int dyMax = (rows < 3) ? (int)rows - 1 - cy : 1;
+
+	unsigned int count = 0;
+	for(int dy = dyMin; dy <= dyMax; ++dy)
+	{
+		for(int dx = dxMin; dx <= dxMax; ++dx)
+		{
+			cells[count++] = wrap(cy + dy, rows) * columns + wrap(cx + dx, columns);
+		}
+	}
+	return count;
+}
+
+// SORT THE POPULATION INTO CELLS, CALLED ONCE PER TICK BEFORE PARTNER SEARCH
+// margin: extra reach for searches a little further than sight (neighbour lists)
+void SpatialGrid::rebuild(std::vector<Creature*>& creatures, float margin)
+{
+  // CELL SIZE >= LARGEST REACH (MY SIGHT + YOUR SIZE + MARGIN)
+	float maxSight = 0.f;
+	float maxSize = 0.f;
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		if(creatures[i]->getSightRadius() > maxSight) maxSight = creatures[i]->getSightRadius();
+		if(creatures[i]->getSize() > maxSize) maxSize = creatures[i]->getSize();
+	}
+	rebuildForReach(creatures, maxSight + maxSize + margin);
+}
+
+// SAME, BUT THE CELLS ONLY COVER THAT REACH (QUERIES FURTHER THAN THAT NEED ANOTHER GRID)
+void SpatialGrid::rebuildForReach(std::vector<Creature*>& creatures, float reach)
+{
+	if(reach < 1.f) reach = 1.f;
+
+  // AS MANY CELLS AS FIT, SO THE ACTUAL CELL SIZE NEVER DROPS BELOW THE REACH
+	columns = (unsigned int)(windowSize->x / reach);
+	rows = (unsigned int)(windowSize->y / reach);
+	if(columns < 1) columns = 1;
+	if(rows < 1) rows = 1;
+	cellWidth = std::max(reach, (float)windowSize->x / columns);
+	cellHeight = std::max(reach, (float)windowSize->y / rows);
+
+  // COUNT
+	unsigned int cellCount = columns * rows;
+	cellStart.assign(cellCount + 1, 0);
+	entryCell.resize(creatures.size());
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		entryCell[i] = cellOf(creatures[i]->getPosition());
+		++cellStart[entryCell[i] + 1];
+	}
+
+  // PREFIX SUM
+	for(unsigned int c = 0; c < cellCount; ++c)
+		cellStart[c + 1] += cellStart[c];
+
+  // SCATTER
+	cursor.assign(cellStart.begin(), cellStart.end() - 1);
+	entries.resize(creatures.size());
+	entryIndex.resize(creatures.size());
+	entryX.resize(creatures.size());
+	entryY.resize(creatures.size());
+	entryRadius.resize(creatures.size());
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		unsigned int slot = cursor[entryCell[i]]++;
+		entries[slot] = creatures[i];
+		entryIndex[slot] = i;
+		entryX[slot] = creatures[i]->getPosition().x;
+		entryY[slot] = creatures[i]->getPosition().y;
+		entryRadius[slot] = creatures[i]->getRadius();
+	}
+}
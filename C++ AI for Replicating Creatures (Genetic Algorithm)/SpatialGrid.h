@@ -0,0 +1,60 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+#include "AlignedAllocator.h"
+
+class Creature;
+
+// UNIFORM GRID OVER THE (TOROIDAL) WINDOW
+// cells are at least as big as the largest sightRadius + size in the population (+ margin),
+// so everything a creature can see lies in the 3x3 cells around it
+class SpatialGrid
+{
+private:
+	sf::Vector2u* windowSize;
+
+	float cellWidth;
+	float cellHeight;
+	unsigned int columns;
+	unsigned int rows;
+
+  // entries sorted by cell (counting sort, stable in population order)
+	std::vector<unsigned int> cellStart;
+	std::vector<unsigned int> cursor;
+	std::vector<unsigned int> entryCell;
+	std::vector<unsigned int> entryIndex;
+	std::vector<Creature*> entries;
+
+  // positions and radii of the entries, contiguous for the batched sight test
+	AlignedVector<float> entryX;
+	AlignedVector<float> entryY;
+	AlignedVector<float> entryRadius;
+
+	unsigned int wrap(int cell, unsigned int count) const;
+
+public:
+  // constructor
+	SpatialGrid(sf::Vector2u&);
+
+  // Methods
+	void rebuild(std::vector<Creature*>&, float margin = 0.f);
+	void rebuildForReach(std::vector<Creature*>&, float reach);
+
+	unsigned int cellOf(const sf::Vector2f&) const;
+	unsigned int getNeighbourCells(const sf::Vector2f&, unsigned int cells[9]) const;
+
+  // GETTERS
+	float getCellWidth() const { return cellWidth; }
+	float getCellHeight() const { return cellHeight; }
+	unsigned int getColumns() const { return columns; }
+	unsigned int getRows() const { return rows; }
+	unsigned int getCellBegin(unsigned int cell) const { return cellStart[cell]; }
+	unsigned int getCellEnd(unsigned int cell) const { return cellStart[cell + 1]; }
+	Creature* getEntry(unsigned int i) const { return entries[i]; }
+	unsigned int getEntryIndex(unsigned int i) const { return entryIndex[i]; }
+	const float* getEntryX() const { return entryX.data(); }
+	const float* getEntryY() const { return entryY.data(); }
+	const float* getEntryRadius() const { return entryRadius.data(); }
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// SINGLE PRODUCER / SINGLE CONSUMER RING, NO LOCKS
+// one thread pushes, one other thread pops. head and tail only ever grow (they wrap
+// around unsigned int), the slot of an index is index & mask
+template<typename T>
+class SpscRing
+{
+private:
+	std::vector<T> items;
+	unsigned int mask;
+
+  // padded onto separate cache lines, producer and consumer don't fight over them
+  // (padding instead of alignas, plain new doesn't honour over-alignment before C++17)
+	char padding0[64];
+	std::atomic<unsigned int> head;
+	char padding1[64 - sizeof(std::atomic<unsigned int>)];
+	std::atomic<unsigned int> tail;
+	char padding2[64 - sizeof(std::atomic<unsigned int>)];
+
+public:
+  // constructor (capacity is rounded up to a power of two)
+	SpscRing(unsigned int capacity)
+		: head(0), tail(0)
+	{
+		unsigned int size = 1;
+		while(size < capacity)
+			size <<= 1;
+		items.resize(size);
+		mask = size - 1;
+	}
+
+  // PRODUCER SIDE (FALSE IF FULL)
+	bool push(const T& item)
+	{
+		unsigned int t = tail.load(std::memory_order_relaxed);
+		if(t - head.load(std::memory_order_acquire) > mask)
+			return false;
+		items[t & mask] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+  // CONSUMER SIDE (FALSE IF EMPTY)
+	bool pop(T& item)
+	{
+		unsigned int h = head.load(std::memory_order_relaxed);
+		if(h == tail.load(std::memory_order_acquire))
+			return false;
+		item = items[h & mask];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+  // CONSUMER SIDE (SOMETHING PUSHED SINCE MIGHT NOT BE SEEN YET)
+	bool isEmpty() const
+	{
+		return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+	}
+
+private:
+	SpscRing(const SpscRing&);
+	SpscRing& operator=(const SpscRing&);
+};
@@ -0,0 +1,140 @@
+#include "StateHash.h"
+#include "CreaturePool.h"
+#include "Genome.h"
+#include "Profiler.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	const unsigned long long MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+  // ONE MORE VALUE INTO A CREATURE'S HASH
+	inline unsigned long long fold(unsigned long long h, unsigned long long value)
+	{
+		h = (h ^ value) * MULTIPLIER;
+		return h ^ (h >> 29);
+	}
+
+	inline unsigned long long bits(float f)
+	{
+		unsigned int b;
+		memcpy(&b, &f, sizeof(b));
+		return b;
+	}
+
+  // SPLITMIX64 FINALIZER: CREATURE HASHES ARE ADDED UP, SO EVERY BIT HAS TO COUNT
+	inline unsigned long long finish(unsigned long long x)
+	{
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+}
+
+StateHash::StateHash(unsigned int i)
+	: interval(i == 0 ? 1 : i), checked(0), mismatch(-1)
+{
+}
+
+// HASH OF EVERY LIVING CREATURE (IN ANY ORDER) AND THE POPULATION SIZE
+unsigned long long StateHash::hash(CreaturePool& pool)
+{
+	PROFILE_SCOPE("stateHash");
+	CreatureData& data = pool.getData();
+	std::vector<Creature*>& creatures = pool.getCreatures();
+
+	unsigned long long sum = finish(creatures.size());
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		Creature* c = creatures[i];
+		unsigned int slot = c->getSlot();
+		Creature* partner = c->getPartner();
+
+		unsigned long long h = fold(0, (unsigned int)c->getId());
+		h = fold(h, bits(c->getPosition().x) | bits(c->getPosition().y) << 32);
+		h = fold(h, bits(c->getTargetPosition().x) | bits(c->getTargetPosition().y) << 32);
+		h = fold(h, (unsigned long long)c->getLifeTime() | (unsigned long long)data.randomDraws[slot] << 32);
+		h = fold(h, (unsigned long long)(unsigned int)(partner != NULL ? partner->getId() : -1) | (unsigned long long)data.state[slot] << 32);
+
+    // EVERY GENE THE GENOME HAS, AS IT WOULD BE SAVED
+		unsigned int genes[Genome::Genes::COUNT];
+		Genome::Genes::save(data.genes, slot, genes);
+		for(unsigned int g = 0; g < Genome::Genes::COUNT; ++g)
+			h = fold(h, genes[g]);
+		sum += finish(h);
+	}
+	return sum;
+}
+
+// CALL AFTER EVERY TICK: HASHES EVERY interval TICKS, AND CHECKS THE HASH IN A REPLAY
+void StateHash::record(CreaturePool& pool, unsigned long long tick)
+{
+	if(tick % interval != 0)
+		return;
+
+	Entry e;
+	e.tick = tick;
+	e.hash = hash(pool);
+	stream.push_back(e);
+
+	if(checked < expected.size())
+	{
+		const Entry& x = expected[checked++];
+		if(mismatch < 0 && (x.tick != e.tick || x.hash != e.hash))
+			mismatch = (long long)tick;
+	}
+}
+
+// REPLAY: EVERY RECORDED HASH HAS TO MATCH THIS STREAM
+void StateHash::expect(const std::vector<Entry>& e)
+{
+	expected = e;
+	checked = 0;
+	mismatch = -1;
+}
+
+void StateHash::clear()
+{
+	stream.clear();
+	expected.clear();
+	checked = 0;
+	mismatch = -1;
+}
+
+// ALL HASHES FOLDED INTO ONE NUMBER (TWO RUNS AGREE IF THEIR CHAINS DO)
+unsigned long long StateHash::getChain() const
+{
+	unsigned long long chain = 0;
+	for(unsigned int i = 0; i < stream.size(); ++i)
+		chain = finish(fold(fold(chain, stream[i].tick), stream[i].hash));
+	return chain;
+}
+
+// ONE LINE PER ENTRY: TICK AND HASH (TEXT, SO TWO STREAMS CAN BE DIFFED)
+bool StateHash::save(const std::string& path) const
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if(file == NULL)
+		return false;
+
+	for(unsigned int i = 0; i < stream.size(); ++i)
+		fprintf(file, "%llu %016llx\n", stream[i].tick, stream[i].hash);
+	return fclose(file) == 0;
+}
+
+bool StateHash::load(const std::string& path, std::vector<Entry>& entries)
+{
+	FILE* file = fopen(path.c_str(), "r");
+	if(file == NULL)
+		return false;
+
+	entries.clear();
+	Entry e;
+	while(fscanf(file, "%llu %llx", &e.tick, &e.hash) == 2)
+		entries.push_back(e);
+	bool ok = feof(file) != 0;
+	fclose(file);
+	return ok;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class CreaturePool;
+
+// HASH STREAM OF THE WHOLE POPULATION, TO PROVE THAT TWO RUNS SIMULATED THE SAME THING
+// every interval ticks the state of every creature (id, position, target, life time, dice
+// counter, partner id, state bits and every gene of Genome::Genes) is hashed. creatures are hashed one by one and
+// added up, so the hash doesn't depend on the order of the population or on which slot a
+// creature sits in: a change of threads, SIMD kernels or memory layout keeps the stream,
+// a change of behaviour breaks it at the first tick it shows.
+// a hash is a full O(n) pass over the population: nearly every creature moves every tick, so
+// there is little an incremental hash could skip. it costs about half of the update phase,
+// give the constructor an interval to only pay for it every interval ticks
+// record a stream, save it, and expect() it in a replay from the same seed
+class StateHash
+{
+public:
+	struct Entry
+	{
+		unsigned long long tick;
+		unsigned long long hash;
+	};
+
+private:
+	unsigned int interval;
+	std::vector<Entry> stream;
+
+  // what a replay has to match (empty = only recording)
+	std::vector<Entry> expected;
+	unsigned int checked;
+	long long mismatch;
+
+public:
+  // constructor
+	StateHash(unsigned int interval = 1);
+
+  // Methods
+	static unsigned long long hash(CreaturePool&);
+
+	void record(CreaturePool&, unsigned long long tick);
+	void expect(const std::vector<Entry>&);
+	void clear();
+
+	bool save(const std::string& path) const;
+	static bool load(const std::string& path, std::vector<Entry>&);
+
+  // GETTERS
+	const std::vector<Entry>& getStream() const { return stream; }
+	unsigned long long getChain() const;
+	bool isReplaying() const { return !expected.empty(); }
+	unsigned int getExpectedCount() const { return expected.size(); }
+	unsigned int getCheckedCount() const { return checked; }
+	bool hasMismatch() const { return mismatch >= 0; }
+	long long getMismatchTick() const { return mismatch; }
+};
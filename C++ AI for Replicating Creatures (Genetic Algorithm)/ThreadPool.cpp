@@ -0,0 +1,86 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threads)
+	: job(NULL), count(0), generation(0), pending(0), stopping(false)
+{
+	if(threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+
+  // THE CALLING THREAD IS THREAD 0
+	for(unsigned int i = 1; i < threads; ++i)
+		workers.push_back(std::thread(&ThreadPool::work, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for(unsigned int i = 0; i < workers.size(); ++i)
+		workers[i].join();
+}
+
+// DO MY PART OF THE CURRENT JOB
+void ThreadPool::runChunk(unsigned int thread)
+{
+	unsigned int threads = getThreadCount();
+	unsigned int begin = getChunkBegin(count, threads, thread);
+	unsigned int end = getChunkBegin(count, threads, thread + 1);
+	if(begin < end)
+		(*job)(begin, end, thread);
+}
+
+// WORKER LOOP: WAIT FOR A NEW GENERATION, RUN THE CHUNK, REPORT BACK
+void ThreadPool::work(unsigned int thread)
+{
+	unsigned int seen = 0;
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while(!stopping && generation == seen)
+				wake.wait(lock);
+			if(stopping)
+				return;
+			seen = generation;
+		}
+
+		runChunk(thread);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(--pending == 0)
+				finished.notify_one();
+		}
+	}
+}
+
+// PARALLEL FOR OVER [0, count), RETURNS WHEN EVERYTHING IS DONE
+void ThreadPool::run(unsigned int n, const Job& j)
+{
+	if(workers.empty())
+	{
+		if(n > 0) j(0, n, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &j;
+		count = n;
+		pending = workers.size();
+		++generation;
+	}
+	wake.notify_all();
+
+	runChunk(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while(pending > 0)
+		finished.wait(lock);
+	job = NULL;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// FIXED SET OF WORKER THREADS FOR PARALLEL LOOPS
+// run() splits [0, count) into one contiguous chunk per thread (in order), the
+// calling thread works on chunk 0 and waits until every chunk is done
+class ThreadPool
+{
+public:
+	typedef std::function<void(unsigned int begin, unsigned int end, unsigned int thread)> Job;
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+
+	const Job* job;
+	unsigned int count;
+	unsigned int generation;
+	unsigned int pending;
+	bool stopping;
+
+	void work(unsigned int thread);
+	void runChunk(unsigned int thread);
+
+public:
+  // constructor (0 threads = one per hardware thread)
+	ThreadPool(unsigned int threads = 0);
+	~ThreadPool();
+
+  // Methods
+	void run(unsigned int count, const Job& job);
+
+  // GETTERS
+	unsigned int getThreadCount() const { return workers.size() + 1; }
+	static unsigned int getChunkBegin(unsigned int count, unsigned int chunks, unsigned int chunk)
+	{
+		return (unsigned int)((unsigned long long)count * chunk / chunks);
+	}
+
+private:
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+class Creature;
+
+// A CREATURE WANTS TO MOVE TOWARDS A PARTNER
+// keep: it already had that partner, otherwise it claims a new one
+struct PartnerProposal
+{
+	Creature* creature;
+	Creature* partner;
+	bool keep;
+};
+
+// EVERYTHING A THREAD WANTS TO DO TO OTHER CREATURES DURING A PARALLEL PHASE
+// the pool applies these afterwards, buffer by buffer in population order
+struct TickBuffer
+{
+	std::vector<Creature*> diedPartners;
+	std::vector<PartnerProposal> proposals;
+	float largestStepSquared;
+
+	TickBuffer() : largestStepSquared(0.f) {}
+
+	void clear()
+	{
+		diedPartners.clear();
+		proposals.clear();
+		largestStepSquared = 0.f;
+	}
+};
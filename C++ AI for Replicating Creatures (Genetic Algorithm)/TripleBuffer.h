@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+
+// HANDS THE LATEST T FROM ONE WRITER THREAD TO ONE READER THREAD WITHOUT EITHER EVER WAITING
+// three items: the writer fills the back one, the reader reads the front one and the middle
+// one is swapped with either side in a single atomic exchange. publishing overwrites an item
+// the reader didn't pick up yet, so the reader always gets the latest one
+template<typename T>
+class TripleBuffer
+{
+private:
+	static const unsigned int FRESH = 1 << 2;
+
+	T items[3];
+	unsigned int back;
+	unsigned int front;
+
+  // index of the middle item, | FRESH if it was published and not picked up yet
+	char padding0[64];
+	std::atomic<unsigned int> middle;
+	char padding1[64 - sizeof(std::atomic<unsigned int>)];
+
+public:
+  // constructor (plain data items start zeroed)
+	TripleBuffer()
+		: items(), back(0), front(2), middle(1)
+	{
+	}
+
+  // WRITER SIDE
+	T& getBack() { return items[back]; }
+
+  // THE BACK ITEM IS DONE, IT BECOMES THE MIDDLE ONE (THE OLD MIDDLE ONE IS WRITTEN NEXT)
+	void publish()
+	{
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+  // DID THE READER PICK UP THE LAST ITEM?
+	bool isPickedUp() const
+	{
+		return (middle.load(std::memory_order_acquire) & FRESH) == 0;
+	}
+
+  // READER SIDE (true if there is a newer item than the one already in front)
+	bool acquire()
+	{
+		if((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+			return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+		return true;
+	}
+
+	const T& getFront() const { return items[front]; }
+
+private:
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+};
@@ -0,0 +1,329 @@
+#include "WorldShard.h"
+#include "CreatureRecord.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	float wrap(float v, float size)
+	{
+		return v - floorf(v / size) * size;
+	}
+}
+
+WorldShard::WorldShard(CreaturePool& p, ShardTransport* t, unsigned int c, unsigned int r, unsigned int s, float h)
+	: pool(&p), transport(t), columns(c < 1 ? 1 : c), rows(r < 1 ? 1 : r), shard(s), halo(h),
+	peerIndex(columns * rows, -1), migrantsOut(0), migrantsIn(0), lost(0)
+{
+	tileSize = sf::Vector2f((float)pool->windowSize->x / columns, (float)pool->windowSize->y / rows);
+
+  // GHOST SLOTS CHANGE EVERY TICK, CACHED NEIGHBOUR LISTS WOULD LOSE THEM
+	pool->setNeighbourLists(false);
+
+  // THE (UP TO) 8 TILES AROUND MINE, EVERY SHARD ONCE AND NEVER MYSELF (NONE WITHOUT A TRANSPORT)
+	int column = shard % columns;
+	int row = shard / columns;
+	for(int dy = -1; dy <= 1 && transport != NULL; ++dy)
+	{
+		for(int dx = -1; dx <= 1; ++dx)
+		{
+			unsigned int neighbour = getShard(column + dx, row + dy);
+			if(neighbour != shard && std::find(peers.begin(), peers.end(), neighbour) == peers.end())
+				peers.push_back(neighbour);
+		}
+	}
+	std::sort(peers.begin(), peers.end());
+	for(unsigned int i = 0; i < peers.size(); ++i)
+		peerIndex[peers[i]] = i;
+
+	messages.resize(peers.size());
+	halos.resize(peers.size());
+	incoming.resize(peers.size());
+	ghostPartnerIds.assign(pool->getCapacity(), -1);
+}
+
+// TILE COORDINATES WRAP AROUND LIKE THE WORLD
+unsigned int WorldShard::getShard(int column, int row) const
+{
+	column = ((column % (int)columns) + columns) % columns;
+	row = ((row % (int)rows) + rows) % rows;
+	return row * columns + column;
+}
+
+unsigned int WorldShard::ownerOf(const sf::Vector2f& p) const
+{
+	float x = wrap(p.x, (float)pool->windowSize->x);
+	float y = wrap(p.y, (float)pool->windowSize->y);
+	int column = std::min((unsigned int)(x / tileSize.x), columns - 1);
+	int row = std::min((unsigned int)(y / tileSize.y), rows - 1);
+	return getShard(column, row);
+}
+
+// THE SHARDS (BESIDES THE OWNER) WHOSE TILE IS LESS THAN A HALO AWAY FROM THAT POSITION
+unsigned int WorldShard::getHaloShards(const sf::Vector2f& p, unsigned int shards[MAX_PEERS]) const
+{
+	unsigned int owner = ownerOf(p);
+	int column = owner % columns;
+	int row = owner / columns;
+	float x = wrap(p.x, (float)pool->windowSize->x) - column * tileSize.x;
+	float y = wrap(p.y, (float)pool->windowSize->y) - row * tileSize.y;
+
+	int dxMin = (x < halo) ? -1 : 0;
+	int dxMax = (x > tileSize.x - halo) ? 1 : 0;
+	int dyMin = (y < halo) ? -1 : 0;
+	int dyMax = (y > tileSize.y - halo) ? 1 : 0;
+
+	unsigned int count = 0;
+	for(int dy = dyMin; dy <= dyMax; ++dy)
+	{
+		for(int dx = dxMin; dx <= dxMax; ++dx)
+		{
+			unsigned int s = getShard(column + dx, row + dy);
+			if(s != owner && std::find(shards, shards + count, s) == shards + count)
+				shards[count++] = s;
+		}
+	}
+	return count;
+}
+
+// START THE WORLD: EVERY SHARD ROLLS THE SAME POPULATION AND KEEPS WHAT LIES IN ITS TILE
+// afterwards the shards hand out interleaved ids, so newborns never share one
+void WorldShard::populate(unsigned int count)
+{
+	CreatureData& data = pool->data;
+	int first = Creature::ID;
+	Creature::ID_STEP = 1;
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		Creature* c = pool->spawn();
+		if(c == NULL || ownerOf(c->getPosition()) == shard)
+			continue;
+
+    // NOT MINE, GIVE THE SLOT BACK RIGHT AWAY
+		++data.generation[c->getSlot()];
+		pool->freeSlots.push_back(c->getSlot());
+		pool->creatures.pop_back();
+		if(pool->stats != NULL) pool->stats->remove(c);
+	}
+
+	Creature::ID = first + count + shard;
+	Creature::ID_STEP = columns * rows;
+}
+
+// ONE SIMULATION STEP, SAME PHASES AS CreaturePool::tick WITH THE EXCHANGE BEFORE THE PARTNER SEARCH
+// every shard of the world has to call this once per tick, the exchange waits for all neighbours
+void WorldShard::tick(int delta)
+{
+	{
+		PROFILE_SCOPE("tick");
+		pool->update(delta);
+		pool->removeDead();
+		exchange();
+		pool->searchPartners();
+		pool->replicate();
+		++pool->tickCount;
+		if(pool->stats != NULL) pool->stats->publish(pool->tickCount);
+	}
+	PROFILE_TICK();
+}
+
+// A SLOT FOR A COPY OF SOMEONE ELSE'S CREATURE (NULL IF THE POOL IS FULL)
+Creature* WorldShard::addGhost()
+{
+	if(pool->freeSlots.empty())
+		return NULL;
+
+	Creature* c = &pool->views[pool->freeSlots.back()];
+	pool->freeSlots.pop_back();
+	pool->ghosts.push_back(c);
+	return c;
+}
+
+// LAST TICK'S GHOSTS ARE OUTDATED, EVERY HANDLE ONTO THEM GOES STALE
+void WorldShard::clearGhosts()
+{
+	CreatureData& data = pool->data;
+	for(unsigned int i = 0; i < pool->ghosts.size(); ++i)
+	{
+		unsigned int slot = pool->ghosts[i]->getSlot();
+		++data.generation[slot];
+		ghostPartnerIds[slot] = -1;
+		pool->freeSlots.push_back(slot);
+	}
+	pool->ghosts.clear();
+}
+
+// SEND MIGRANTS AND HALO, RECEIVE THEIRS, THEN LINK THE PARTNERS BY ID AGAIN
+void WorldShard::exchange()
+{
+	PROFILE_SCOPE("shardExchange");
+	CreatureData& data = pool->data;
+	std::vector<Creature*>& creatures = pool->creatures;
+
+  // WHO'S WITH WHOM (HANDLES ONTO GHOSTS AND MIGRANTS ARE ABOUT TO GO STALE)
+	partnerIds.resize(creatures.size());
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		Creature* partner = creatures[i]->getPartner();
+		partnerIds[i] = (partner != NULL) ? partner->getId() : -1;
+	}
+	clearGhosts();
+
+	for(unsigned int p = 0; p < peers.size(); ++p)
+	{
+		messages[p].clear();
+		halos[p].clear();
+	}
+
+  // PACK (MIGRANTS LEAVE MY POPULATION, BUT CAN STILL BE A GHOST HERE)
+	unsigned int kept = 0;
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		Creature* c = creatures[i];
+		int owner = peerIndex[ownerOf(c->getPosition())];
+
+		unsigned int shards[MAX_PEERS];
+		unsigned int count = getHaloShards(c->getPosition(), shards);
+		bool ghostHere = false;
+		for(unsigned int s = 0; s < count; ++s)
+		{
+			if(shards[s] == shard)
+				ghostHere = true;
+			else if(peerIndex[shards[s]] >= 0)
+				CreatureRecord::capture(data, c, partnerIds[i]).write(halos[peerIndex[shards[s]]]);
+		}
+
+    // STILL MINE (OR WALKED FURTHER THAN A NEIGHBOUR TILE, THEN IT STAYS UNTIL IT COMES BACK)
+		if(owner < 0)
+		{
+			partnerIds[kept] = partnerIds[i];
+			creatures[kept++] = c;
+			continue;
+		}
+
+		CreatureRecord::capture(data, c, partnerIds[i]).write(messages[owner]);
+		++migrantsOut;
+		if(pool->stats != NULL) pool->stats->remove(c);
+
+    // NOT MINE ANYMORE: ITS LIFECYCLE EVENTS AND HANDLES GO STALE EITHER WAY
+		++data.generation[c->getSlot()];
+		if(ghostHere)
+		{
+			pool->ghosts.push_back(c);
+			data.state[c->getSlot()] |= CreatureData::GHOST;
+			ghostPartnerIds[c->getSlot()] = partnerIds[i];
+		}
+		else
+			pool->freeSlots.push_back(c->getSlot());
+	}
+	creatures.resize(kept);
+	partnerIds.resize(kept);
+	pool->reindex(0);
+
+  // MESSAGE: [MIGRANT COUNT][MIGRANTS][GHOSTS]
+	for(unsigned int p = 0; p < peers.size(); ++p)
+	{
+		unsigned int count = messages[p].size() / sizeof(CreatureRecord);
+		messages[p].insert(messages[p].begin(), (const char*)&count, (const char*)&count + sizeof(count));
+		messages[p].insert(messages[p].end(), halos[p].begin(), halos[p].end());
+	}
+	if(!peers.empty())
+		transport->exchange(peers, messages, incoming);
+
+  // UNPACK, PEER BY PEER: FIRST EVERYONE WHO MOVED IN, THEN THE GHOSTS
+	for(unsigned int p = 0; p < peers.size(); ++p)
+	{
+		unsigned int count;
+		memcpy(&count, &incoming[p][0], sizeof(count));
+		for(unsigned int m = 0; m < count; ++m)
+		{
+			Creature* c = pool->allocate();
+			if(c == NULL)
+			{
+				++lost;
+				continue;
+			}
+			CreatureRecord r = CreatureRecord::read(&incoming[p][sizeof(count) + m * sizeof(CreatureRecord)]);
+			r.restore(data, c);
+			partnerIds.push_back(r.partner);
+			pool->settle(c);
+			++migrantsIn;
+		}
+	}
+	for(unsigned int p = 0; p < peers.size(); ++p)
+	{
+		unsigned int count;
+		memcpy(&count, &incoming[p][0], sizeof(count));
+		unsigned int total = (incoming[p].size() - sizeof(count)) / sizeof(CreatureRecord);
+		for(unsigned int g = count; g < total; ++g)
+		{
+			Creature* c = addGhost();
+			if(c == NULL)
+				break;
+			CreatureRecord r = CreatureRecord::read(&incoming[p][sizeof(count) + g * sizeof(CreatureRecord)]);
+			r.restore(data, c);
+			ghostPartnerIds[c->getSlot()] = r.partner;
+			data.state[c->getSlot()] |= CreatureData::GHOST;
+		}
+	}
+
+  // IDS -> HANDLES
+	byId.clear();
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+		byId[creatures[i]->getId()] = creatures[i];
+	for(unsigned int i = 0; i < pool->ghosts.size(); ++i)
+		byId[pool->ghosts[i]->getId()] = pool->ghosts[i];
+
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		std::unordered_map<int, Creature*>::iterator found = byId.find(partnerIds[i]);
+		creatures[i]->setPartner((partnerIds[i] >= 0 && found != byId.end()) ? found->second : NULL);
+	}
+	for(unsigned int i = 0; i < pool->ghosts.size(); ++i)
+	{
+		int partner = ghostPartnerIds[pool->ghosts[i]->getSlot()];
+		std::unordered_map<int, Creature*>::iterator found = byId.find(partner);
+		pool->ghosts[i]->setPartner((partner >= 0 && found != byId.end()) ? found->second : NULL);
+	}
+
+	agreeOnPartners();
+}
+
+// PAIRS ACROSS A BORDER, IN POPULATION ORDER (SO EVERY SHARD DECIDES THE SAME WAY EVERY RUN)
+void WorldShard::agreeOnPartners()
+{
+	std::vector<Creature*>& creatures = pool->creatures;
+
+  // MY CLAIMS: KEEP WHILE THE OTHER SIDE AGREES OR HASN'T ANSWERED YET
+	for(unsigned int i = 0; i < creatures.size(); ++i)
+	{
+		Creature* c = creatures[i];
+		Creature* partner = c->getPartner();
+		if(partner == NULL || !partner->isGhost())
+			continue;
+
+    // A DYING PARTNER CAN'T REPLICATE ANYMORE (THAT'S partnerDied IN ONE POOL)
+		if(c->isDying() || partner->isDying())
+			c->partnerDied();
+		else if(partner->getPartner() != c && ghostPartnerIds[partner->getSlot()] != -1)
+			c->partnerDied();
+	}
+
+  // THEIR CLAIMS ON MY CREATURES: ACCEPT IF MINE IS STILL FREE
+	for(unsigned int i = 0; i < pool->ghosts.size(); ++i)
+	{
+		Creature* ghost = pool->ghosts[i];
+		Creature* mine = ghost->getPartner();
+		if(mine == NULL || mine->isGhost() || mine->getPartner() != NULL || !mine->isAvailableFor(ghost))
+			continue;
+
+		PartnerProposal proposal;
+		proposal.creature = mine;
+		proposal.partner = ghost;
+		proposal.keep = false;
+		mine->commitPartner(proposal);
+	}
+}
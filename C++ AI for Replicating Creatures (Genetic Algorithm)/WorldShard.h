@@ -0,0 +1,83 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "CreaturePool.h"
+#include "ShardTransport.h"
+
+// ONE TILE OF A WORLD THAT IS SPLIT OVER SEVERAL PROCESSES
+// the toroidal world (the pool's window size) is cut into columns x rows tiles, every
+// shard owns the creatures inside its tile and runs them in its own pool. every tick,
+// between the update and the partner search, it sends its neighbour tiles
+//   - migrants: creatures that walked into their tile (they change owner), and
+//   - the halo: copies of creatures close enough to their border to be seen from there
+// the halo copies are ghosts in the receiving pool: they can be found as partners, nothing
+// else touches them, and the next exchange replaces them.
+//
+// partners across a border are linked by id and have to agree: a claim on a ghost is
+// accepted by the shard that owns it a tick later (if that creature is still free),
+// and dropped as soon as the owner shows a different partner. both shards of a pair see
+// the same replication state, the one with the lower id gets the baby.
+// the sharded world is deterministic, but doesn't play out like one big pool: claims
+// across a border take a tick longer and newborn ids are interleaved between the shards.
+// tiles have to be at least twice the halo wide and high, the halo has to cover the
+// longest sight + largest size (sight is at most size + 100 for every creature)
+class WorldShard
+{
+public:
+	static const unsigned int MAX_PEERS = 8;
+
+private:
+	CreaturePool* pool;
+	ShardTransport* transport;
+
+	unsigned int columns;
+	unsigned int rows;
+	unsigned int shard;
+	float halo;
+	sf::Vector2f tileSize;
+
+	std::vector<unsigned int> peers;
+	std::vector<int> peerIndex;
+	std::vector<std::vector<char> > messages;
+	std::vector<std::vector<char> > halos;
+	std::vector<std::vector<char> > incoming;
+
+  // partners by id while handles are rebuilt, and the partner id every ghost came with
+	std::vector<int> partnerIds;
+	std::vector<int> ghostPartnerIds;
+	std::unordered_map<int, Creature*> byId;
+
+	unsigned long long migrantsOut;
+	unsigned long long migrantsIn;
+	unsigned long long lost;
+
+	unsigned int getShard(int column, int row) const;
+	unsigned int getHaloShards(const sf::Vector2f&, unsigned int shards[MAX_PEERS]) const;
+	Creature* addGhost();
+	void clearGhosts();
+	void exchange();
+	void agreeOnPartners();
+
+public:
+  // constructor (transport may be NULL for a world of a single tile)
+	WorldShard(CreaturePool&, ShardTransport*, unsigned int columns, unsigned int rows, unsigned int shard, float halo = 128.f);
+
+  // Methods
+	void populate(unsigned int count);
+	void tick(int delta);
+
+	unsigned int ownerOf(const sf::Vector2f&) const;
+
+  // GETTERS
+	CreaturePool& getPool() { return *pool; }
+	unsigned int getShard() const { return shard; }
+	unsigned int getShardCount() const { return columns * rows; }
+	const std::vector<unsigned int>& getPeers() const { return peers; }
+	unsigned int getGhostCount() const { return pool->ghosts.size(); }
+	unsigned long long getMigrantsOut() const { return migrantsOut; }
+	unsigned long long getMigrantsIn() const { return migrantsIn; }
+	unsigned long long getLost() const { return lost; }
+};